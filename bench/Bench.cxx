@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ZThread {
+
+  BenchReporter::BenchReporter(bool json) : _json(json), _first(true) {
+
+    if(_json)
+      std::printf("[\n");
+    else
+      std::printf("benchmark,primitive,threads,operations,seconds,ns_per_op,ops_per_sec\n");
+
+  }
+
+  BenchReporter::~BenchReporter() {
+
+    if(_json)
+      std::printf("\n]\n");
+
+  }
+
+  void BenchReporter::report(const char* benchmark, const char* primitive, unsigned int threads, 
+                             unsigned long operations, double seconds) {
+    
+    double nsPerOp = operations ? (seconds * 1e9) / operations : 0.0;
+    double opsPerSec = seconds > 0.0 ? operations / seconds : 0.0;
+
+    if(_json) {
+
+      std::printf("%s  { \"benchmark\": \"%s\", \"primitive\": \"%s\", \"threads\": %u, "
+                  "\"operations\": %lu, \"seconds\": %.6f, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f }",
+                  _first ? "" : ",\n", benchmark, primitive, threads, operations, seconds, nsPerOp, opsPerSec);
+
+    } else {
+
+      std::printf("%s,%s,%u,%lu,%.6f,%.2f,%.0f\n", 
+                  benchmark, primitive, threads, operations, seconds, nsPerOp, opsPerSec);
+
+    }
+
+    _first = false;
+    std::fflush(stdout);
+
+  }
+
+  BenchThreads::~BenchThreads() {
+
+    for(std::vector<Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+      delete *i;
+
+  }
+
+  void BenchThreads::start(Runnable* task) {
+    _threads.push_back(new Thread(task));
+  }
+
+  double BenchThreads::run() {
+
+    _gate.wait(_threads.size());
+
+    Stopwatch clock;
+    _gate.open();
+
+    for(std::vector<Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+      (*i)->wait();
+
+    return clock.elapsed();
+
+  }
+
+} // namespace ZThread
+
+using namespace ZThread;
+
+static void usage(const char* name) {
+
+  std::fprintf(stderr, 
+               "usage: %s [-j] [-t threads] [-n iterations] [lock] [condition] [queue] [executor]\n"
+               "  -j             print the results as JSON instead of CSV\n"
+               "  -t threads     largest number of contending threads (default 4)\n"
+               "  -n iterations  operations performed by each thread (default 200000)\n"
+               "With no group named, every group of benchmarks is run.\n", name);
+
+}
+
+int main(int argc, char** argv) {
+
+  BenchOptions options;
+  bool json = false;
+
+  bool locks = false, conditions = false, queues = false, executors = false;
+
+  for(int i = 1; i < argc; ++i) {
+
+    if(std::strcmp(argv[i], "-j") == 0)
+      json = true;
+
+    else if(std::strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      options.threads = std::atoi(argv[++i]);
+
+    else if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      options.iterations = std::strtoul(argv[++i], 0, 10);
+
+    else if(std::strcmp(argv[i], "lock") == 0)
+      locks = true;
+
+    else if(std::strcmp(argv[i], "condition") == 0)
+      conditions = true;
+
+    else if(std::strcmp(argv[i], "queue") == 0)
+      queues = true;
+
+    else if(std::strcmp(argv[i], "executor") == 0)
+      executors = true;
+
+    else {
+
+      usage(argv[0]);
+      return 1;
+
+    }
+
+  }
+
+  if(options.threads < 1 || options.iterations < 1) {
+
+    usage(argv[0]);
+    return 1;
+
+  }
+
+  if(!locks && !conditions && !queues && !executors)
+    locks = conditions = queues = executors = true;
+
+  BenchReporter reporter(json);
+
+  if(locks)
+    lockBenchmarks(reporter, options);
+
+  if(conditions)
+    conditionBenchmarks(reporter, options);
+
+  if(queues)
+    queueBenchmarks(reporter, options);
+
+  if(executors)
+    executorBenchmarks(reporter, options);
+
+  return 0;
+
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTBENCH_H__
+#define __ZTBENCH_H__
+
+#include "zthread/Condition.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Guard.h"
+#include "zthread/Runnable.h"
+#include "zthread/Thread.h"
+
+#include <string>
+#include <vector>
+
+#include <sys/time.h>
+#include <time.h>
+
+namespace ZThread {
+
+  /**
+   * @class Stopwatch
+   *
+   * @version 2.3.3
+   *
+   * Measure elapsed wall clock time with the best resolution available; the monotonic 
+   * clock is used where it exists so that adjustments to the system time don't skew the
+   * results.
+   */
+  class Stopwatch {
+
+    double _start;
+
+    static double now() {
+
+#if defined(CLOCK_MONOTONIC)
+
+      struct timespec ts;
+      ::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+      return ts.tv_sec + ts.tv_nsec / 1e9;
+
+#else
+
+      struct timeval tv;
+      ::gettimeofday(&tv, 0);
+
+      return tv.tv_sec + tv.tv_usec / 1e6;
+
+#endif
+
+    }
+
+  public:
+
+    Stopwatch() : _start(now()) { }
+
+    //! Restart the measurement
+    void reset() {
+      _start = now();
+    }
+
+    //! @return double seconds since the Stopwatch was created or reset
+    double elapsed() const {
+      return now() - _start;
+    }
+
+  };
+
+  /**
+   * @class BenchOptions
+   *
+   * @version 2.3.3
+   *
+   * Settings shared by all of the benchmarks.
+   */
+  struct BenchOptions {
+
+    //! Largest number of threads to contend with, thread counts double up to this
+    unsigned int threads;
+
+    //! Number of operations each thread performs
+    unsigned long iterations;
+
+    BenchOptions() : threads(4), iterations(200000) { }
+
+  };
+
+  /**
+   * @class BenchReporter
+   *
+   * @version 2.3.3
+   *
+   * Collect the results of each benchmark and print them as CSV or as a JSON array on 
+   * the standard output.
+   */
+  class BenchReporter {
+
+    bool _json;
+    bool _first;
+
+  public:
+
+    BenchReporter(bool json);
+
+    ~BenchReporter();
+
+    /**
+     * Record the result of a benchmark.
+     *
+     * @param benchmark name of the benchmark
+     * @param primitive name of the primitive that was measured
+     * @param threads number of threads that were involved
+     * @param operations total number of operations performed by all threads
+     * @param seconds wall clock time the operations took
+     */
+    void report(const char* benchmark, const char* primitive, unsigned int threads,
+                unsigned long operations, double seconds);
+
+  };
+
+  /**
+   * @class StartGate
+   *
+   * @version 2.3.3
+   *
+   * Hold the threads taking part in a benchmark until all of them have started, so that 
+   * the time spent creating threads is not measured.
+   */
+  class StartGate {
+
+    FastMutex _lock;
+    Condition _arrived;
+    Condition _opened;
+
+    unsigned int _count;
+    bool _open;
+
+  public:
+
+    StartGate() : _arrived(_lock), _opened(_lock), _count(0), _open(false) { }
+
+    //! Called by a participating thread, blocks until the gate is opened
+    void pass() {
+
+      Guard<FastMutex> g(_lock);
+
+      ++_count;
+      _arrived.signal();
+
+      while(!_open)
+        _opened.wait();
+
+    }
+
+    //! Wait for the given number of threads to arrive
+    void wait(unsigned int n) {
+
+      Guard<FastMutex> g(_lock);
+
+      while(_count < n)
+        _arrived.wait();
+
+    }
+
+    //! Release the threads that have arrived
+    void open() {
+
+      Guard<FastMutex> g(_lock);
+
+      _open = true;
+      _opened.broadcast();
+
+    }
+
+  };
+
+  /**
+   * @class BenchThreads
+   *
+   * @version 2.3.3
+   *
+   * Start a group of threads behind a StartGate, and time them from the moment the
+   * gate opens until the last one has finished.
+   */
+  class BenchThreads {
+
+    StartGate _gate;
+    std::vector<Thread*> _threads;
+
+  public:
+
+    ~BenchThreads();
+
+    //! @return StartGate the started tasks should pass() before they begin
+    StartGate& gate() {
+      return _gate;
+    }
+
+    //! Start a thread to run the given task
+    void start(Runnable* task);
+
+    //! @return double seconds from opening the gate until every thread finished
+    double run();
+
+  };
+
+  //! Run the lock acquire/release benchmarks
+  void lockBenchmarks(BenchReporter&, const BenchOptions&);
+
+  //! Run the Condition signal/broadcast benchmarks
+  void conditionBenchmarks(BenchReporter&, const BenchOptions&);
+
+  //! Run the Queue throughput benchmarks
+  void queueBenchmarks(BenchReporter&, const BenchOptions&);
+
+  //! Run the PoolExecutor throughput benchmarks, heap allocations made by the 
+  //! measured submits are reported on the standard error
+  void executorBenchmarks(BenchReporter&, const BenchOptions&);
+
+} // namespace ZThread
+
+#endif // __ZTBENCH_H__
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Bench.h"
+
+#include "zthread/Mutex.h"
+
+namespace ZThread {
+
+  namespace {
+
+    //! State passed back and forth by two threads
+    struct PingPong {
+
+      Mutex lock;
+      Condition turnChanged;
+      int turn;
+
+      PingPong() : turnChanged(lock), turn(0) { }
+
+    };
+
+    //! Wait for a turn, then signal() the other player
+    class Player : public Runnable {
+
+      PingPong& _p;
+      StartGate& _gate;
+      int _me;
+      unsigned long _n;
+
+    public:
+
+      Player(PingPong& p, StartGate& gate, int me, unsigned long n)
+        : _p(p), _gate(gate), _me(me), _n(n) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        Guard<Mutex> g(_p.lock);
+
+        for(unsigned long i = 0; i < _n; ++i) {
+
+          while(_p.turn != _me)
+            _p.turnChanged.wait();
+
+          _p.turn = !_me;
+          _p.turnChanged.signal();
+
+        }
+
+      }
+
+    };
+
+    //! State shared by a broadcaster and its listeners
+    struct Broadcast {
+
+      Mutex lock;
+      Condition wake;
+      Condition done;
+      unsigned long round;
+      unsigned int listeners;
+      unsigned int acks;
+      bool stop;
+
+      Broadcast(unsigned int n) 
+        : wake(lock), done(lock), round(0), listeners(n), acks(0), stop(false) { }
+
+    };
+
+    //! broadcast() a new round, then wait for each listener to acknowledge it
+    class Broadcaster : public Runnable {
+
+      Broadcast& _b;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      Broadcaster(Broadcast& b, StartGate& gate, unsigned long n)
+        : _b(b), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        Guard<Mutex> g(_b.lock);
+
+        for(unsigned long i = 0; i < _n; ++i) {
+
+          _b.acks = 0;
+          _b.round++;
+          _b.wake.broadcast();
+
+          while(_b.acks < _b.listeners)
+            _b.done.wait();
+
+        }
+
+        _b.stop = true;
+        _b.wake.broadcast();
+
+      }
+
+    };
+
+    //! Acknowledge each round of a Broadcaster
+    class Listener : public Runnable {
+
+      Broadcast& _b;
+      StartGate& _gate;
+
+    public:
+
+      Listener(Broadcast& b, StartGate& gate) : _b(b), _gate(gate) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        Guard<Mutex> g(_b.lock);
+
+        for(unsigned long seen = 0;;) {
+
+          while(_b.round == seen && !_b.stop)
+            _b.wake.wait();
+
+          if(_b.stop)
+            break;
+
+          seen = _b.round;
+
+          if(++_b.acks == _b.listeners)
+            _b.done.signal();
+
+        }
+
+      }
+
+    };
+
+  } // namespace
+
+  void conditionBenchmarks(BenchReporter& r, const BenchOptions& o) {
+
+    // Blocking operations are much slower than acquiring a lock, keep the 
+    // default run time in line with the other benchmarks
+    unsigned long rounds = o.iterations / 10 ? o.iterations / 10 : 1;
+
+    {
+
+      PingPong p;
+      BenchThreads threads;
+
+      threads.start(new Player(p, threads.gate(), 0, rounds));
+      threads.start(new Player(p, threads.gate(), 1, rounds));
+
+      r.report("signal", "Condition", 2, 2 * rounds, threads.run());
+
+    }
+
+    for(unsigned int n = 1; n <= o.threads; n *= 2) {
+
+      Broadcast b(n);
+      BenchThreads threads;
+
+      for(unsigned int i = 0; i < n; ++i)
+        threads.start(new Listener(b, threads.gate()));
+
+      threads.start(new Broadcaster(b, threads.gate(), rounds));
+
+      r.report("broadcast", "Condition", n, rounds, threads.run());
+
+    }
+
+  }
+
+} // namespace ZThread
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Bench.h"
+
+#include "zthread/AtomicCount.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Guard.h"
+#include "zthread/PoolExecutor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Replace the global operator new so that the heap allocations made while 
+// tasks are submitted can be counted
+#if __cplusplus >= 201103L
+#  define BENCH_THROW_BAD_ALLOC
+#  define BENCH_THROW_NOTHING noexcept
+#else
+#  define BENCH_THROW_BAD_ALLOC throw(std::bad_alloc)
+#  define BENCH_THROW_NOTHING throw()
+#endif
+
+namespace {
+
+  //! Set while operator new calls are counted
+  volatile bool counting = false;
+
+  //! operator new calls made while counting
+  volatile unsigned long allocations = 0;
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+  ZThread::FastMutex allocationLock;
+#endif
+
+  //! Count an operator new call
+  void countAllocation() {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+    __sync_fetch_and_add(&allocations, 1);
+#else
+    ZThread::Guard<ZThread::FastMutex> g(allocationLock);
+    ++allocations;
+#endif
+
+  }
+
+  //! Read the count of operator new calls and start again from 0
+  unsigned long takeAllocations() {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+    return __sync_lock_test_and_set(&allocations, 0);
+#else
+    ZThread::Guard<ZThread::FastMutex> g(allocationLock);
+
+    unsigned long n = allocations;
+    allocations = 0;
+
+    return n;
+#endif
+
+  }
+
+}
+
+void* operator new(std::size_t size) BENCH_THROW_BAD_ALLOC {
+
+  if(counting)
+    countAllocation();
+
+  void* p = std::malloc(size ? size : 1);
+  if(p == 0)
+    throw std::bad_alloc();
+
+  return p;
+
+}
+
+void operator delete(void* p) BENCH_THROW_NOTHING {
+  std::free(p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* p, std::size_t) BENCH_THROW_NOTHING {
+  std::free(p);
+}
+#endif
+
+namespace ZThread {
+
+  namespace {
+
+    //! Tasks submitted between waits
+    const unsigned long BATCH = 1000;
+
+    //! Rounds run before the one that is measured
+    const unsigned int WARMUP = 3;
+
+    //! Does nothing, so that only the cost of executing a task is measured
+    class Noop : public Runnable {
+    public:
+
+      virtual void run() { }
+
+    };
+
+    //! Executes another task from a worker thread
+    class Spawn : public Runnable {
+
+      Executor& _executor;
+      Task _task;
+
+    public:
+
+      Spawn(Executor& executor, const Task& task) 
+        : _executor(executor), _task(task) { }
+
+      virtual void run() { 
+        _executor.execute(_task);
+      }
+
+    };
+
+    //! Execute n tasks from the current thread, waiting after every BATCH
+    void submit(Executor& executor, const Task& task, unsigned long n) {
+
+      for(unsigned long i = 0; i < n; ) {
+
+        for(unsigned long j = 0; i < n && j < BATCH; ++i, ++j)
+          executor.execute(task);
+
+        executor.wait();
+
+      }
+
+    }
+
+    /**
+     * Measure a round of submits once a few rounds just like it have warmed the 
+     * executor up, reporting any heap allocation made during that round.
+     */
+    void measure(BenchReporter& r, const char* benchmark, const char* name, 
+                          unsigned int threads, Executor& executor, const Task& task, 
+                          unsigned long n, unsigned long tasks) {
+
+      for(unsigned int i = 0; i < WARMUP; ++i)
+        submit(executor, task, n);
+
+      takeAllocations();
+      counting = true;
+
+      Stopwatch clock;
+      submit(executor, task, n);
+
+      double seconds = clock.elapsed();
+      counting = false;
+
+      unsigned long made = takeAllocations();
+
+      r.report(benchmark, name, threads, tasks, seconds);
+
+      if(made != 0)
+        std::fprintf(stderr, "%s,%s,%u: %lu heap allocations for %lu tasks\n", 
+                     benchmark, name, threads, made, tasks);
+
+    }
+
+  } // namespace
+
+  void executorBenchmarks(BenchReporter& r, const BenchOptions& o) {
+
+    for(int stealing = 0; stealing < 2; ++stealing) {
+
+      const char* name = stealing ? "PoolExecutor(stealing)" : "PoolExecutor";
+
+      for(unsigned int n = 1; n <= o.threads; n *= 2) {
+
+        PoolExecutor executor(n, stealing ? PoolExecutor::STEALING : PoolExecutor::SHARED);
+
+        Task noop(new Noop);
+        measure(r, "execute", name, n, executor, noop, o.iterations, o.iterations);
+
+        Task spawn(new Spawn(executor, noop));
+        measure(r, "execute-nested", name, n, executor, spawn, o.iterations / 2, o.iterations);
+
+        executor.cancel();
+        executor.wait();
+
+      }
+
+    }
+
+  }
+
+} // namespace ZThread
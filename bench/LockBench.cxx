@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Bench.h"
+
+#include "zthread/BiasedReadWriteLock.h"
+#include "zthread/CountingSemaphore.h"
+#include "zthread/FairReadWriteLock.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Mutex.h"
+#include "zthread/PriorityMutex.h"
+#include "zthread/RecursiveMutex.h"
+#include "zthread/Semaphore.h"
+#include "zthread/StripedReadWriteLock.h"
+#include "zthread/UpgradableReadWriteLock.h"
+
+namespace ZThread {
+
+  namespace {
+
+    //! Acquire and release a Lockable in a tight loop
+    class LockLoop : public Runnable {
+
+      Lockable& _lock;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      LockLoop(Lockable& lock, StartGate& gate, unsigned long n)
+        : _lock(lock), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        for(unsigned long i = 0; i < _n; ++i) {
+          _lock.acquire();
+          _lock.release();
+        }
+
+      }
+
+    };
+
+    void measure(BenchReporter& r, const BenchOptions& o, const char* name, Lockable& lock) {
+
+      // Uncontended, measured on the calling thread
+      Stopwatch clock;
+
+      for(unsigned long i = 0; i < o.iterations; ++i) {
+        lock.acquire();
+        lock.release();
+      }
+
+      r.report("uncontended", name, 1, o.iterations, clock.elapsed());
+
+      // Contended, by a doubling number of threads
+      for(unsigned int n = 2; n <= o.threads; n *= 2) {
+
+        BenchThreads threads;
+
+        for(unsigned int i = 0; i < n; ++i)
+          threads.start(new LockLoop(lock, threads.gate(), o.iterations));
+
+        r.report("contended", name, n, n * o.iterations, threads.run());
+
+      }
+
+    }
+
+  } // namespace
+
+  void lockBenchmarks(BenchReporter& r, const BenchOptions& o) {
+
+    { Mutex lock;                measure(r, o, "Mutex", lock); }
+    { FastMutex lock;            measure(r, o, "FastMutex", lock); }
+    { RecursiveMutex lock;       measure(r, o, "RecursiveMutex", lock); }
+    { PriorityMutex lock;        measure(r, o, "PriorityMutex", lock); }
+    { Semaphore lock(1, 1);      measure(r, o, "Semaphore", lock); }
+    { CountingSemaphore lock(1); measure(r, o, "CountingSemaphore", lock); }
+
+    // Read-only access, where readers never exclude each other
+    { BiasedReadWriteLock lock;  measure(r, o, "BiasedReadWriteLock(read)", lock.getReadLock()); }
+    { FairReadWriteLock lock;    measure(r, o, "FairReadWriteLock(read)", lock.getReadLock()); }
+    { UpgradableReadWriteLock lock; measure(r, o, "UpgradableReadWriteLock(read)", lock.getReadLock()); }
+    { StripedReadWriteLock lock; measure(r, o, "StripedReadWriteLock(read)", lock.getReadLock()); }
+
+  }
+
+} // namespace ZThread
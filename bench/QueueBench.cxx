@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Bench.h"
+
+#include "zthread/BlockingQueue.h"
+#include "zthread/BoundedQueue.h"
+#include "zthread/MonitoredQueue.h"
+#include "zthread/RingQueue.h"
+
+#include <vector>
+
+namespace ZThread {
+
+  namespace {
+
+    //! Capacity given to the bounded queues
+    const size_t CAPACITY = 1024;
+
+    //! Number of values moved per addAll()/drainTo()
+    const size_t BATCH = 64;
+
+    //! add() a number of values to a Queue
+    class Producer : public Runnable {
+
+      Queue<unsigned long>& _q;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      Producer(Queue<unsigned long>& q, StartGate& gate, unsigned long n)
+        : _q(q), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        for(unsigned long i = 0; i < _n; ++i)
+          _q.add(i);
+
+      }
+
+    };
+
+    //! next() a number of values from a Queue
+    class Consumer : public Runnable {
+
+      Queue<unsigned long>& _q;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      Consumer(Queue<unsigned long>& q, StartGate& gate, unsigned long n)
+        : _q(q), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        _gate.pass();
+
+        for(unsigned long i = 0; i < _n; ++i)
+          _q.next();
+
+      }
+
+    };
+
+    //! addAll() a number of values to a Queue, BATCH at a time
+    template <class Q>
+    class BatchProducer : public Runnable {
+
+      Q& _q;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      BatchProducer(Q& q, StartGate& gate, unsigned long n)
+        : _q(q), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        std::vector<unsigned long> batch;
+        batch.reserve(BATCH);
+
+        _gate.pass();
+
+        for(unsigned long i = 0; i < _n; ) {
+
+          batch.clear();
+          for(; i < _n && batch.size() < BATCH; ++i)
+            batch.push_back(i);
+
+          _q.addAll(batch.begin(), batch.end());
+
+        }
+
+      }
+
+    };
+
+    //! drainTo() a number of values from a Queue, up to BATCH at a time
+    template <class Q>
+    class BatchConsumer : public Runnable {
+
+      Q& _q;
+      StartGate& _gate;
+      unsigned long _n;
+
+    public:
+
+      BatchConsumer(Q& q, StartGate& gate, unsigned long n)
+        : _q(q), _gate(gate), _n(n) { }
+
+      virtual void run() {
+
+        unsigned long batch[BATCH];
+
+        _gate.pass();
+
+        for(unsigned long i = 0; i < _n; ) {
+
+          size_t max = _n - i < BATCH ? (size_t)(_n - i) : BATCH;
+          i += _q.drainTo(batch, max, 1000);
+
+        }
+
+      }
+
+    };
+
+    //! Measure throughput with an equal number of producers and consumers
+    template <class Q>
+    void measure(BenchReporter& r, const BenchOptions& o, const char* name, Q* (*create)()) {
+
+      for(unsigned int n = 1; n <= o.threads; n *= 2) {
+
+        Q* q = create();
+
+        {
+
+          BenchThreads threads;
+
+          for(unsigned int i = 0; i < n; ++i) {
+            threads.start(new Producer(*q, threads.gate(), o.iterations));
+            threads.start(new Consumer(*q, threads.gate(), o.iterations));
+          }
+
+          r.report("add-next", name, 2 * n, n * o.iterations, threads.run());
+
+        }
+
+        delete q;
+
+      }
+
+    }
+
+    //! Measure batched throughput with an equal number of producers and consumers
+    template <class Q>
+    void measureBatched(BenchReporter& r, const BenchOptions& o, const char* name, Q* (*create)()) {
+
+      for(unsigned int n = 1; n <= o.threads; n *= 2) {
+
+        Q* q = create();
+
+        {
+
+          BenchThreads threads;
+
+          for(unsigned int i = 0; i < n; ++i) {
+            threads.start(new BatchProducer<Q>(*q, threads.gate(), o.iterations));
+            threads.start(new BatchConsumer<Q>(*q, threads.gate(), o.iterations));
+          }
+
+          r.report("addAll-drainTo", name, 2 * n, n * o.iterations, threads.run());
+
+        }
+
+        delete q;
+
+      }
+
+    }
+
+    MonitoredQueue<unsigned long, FastMutex>* monitored() {
+      return new MonitoredQueue<unsigned long, FastMutex>();
+    }
+
+    BlockingQueue<unsigned long, FastMutex>* blocking() {
+      return new BlockingQueue<unsigned long, FastMutex>();
+    }
+
+    BoundedQueue<unsigned long, FastMutex>* bounded() {
+      return new BoundedQueue<unsigned long, FastMutex>(CAPACITY);
+    }
+
+    RingQueue<unsigned long>* ring() {
+      return new RingQueue<unsigned long>(CAPACITY);
+    }
+
+  } // namespace
+
+  void queueBenchmarks(BenchReporter& r, const BenchOptions& o) {
+
+    measure(r, o, "MonitoredQueue", monitored);
+    measure(r, o, "BlockingQueue", blocking);
+    measure(r, o, "BoundedQueue", bounded);
+    measure(r, o, "RingQueue", ring);
+
+    measureBatched(r, o, "MonitoredQueue", monitored);
+    measureBatched(r, o, "BlockingQueue", blocking);
+    measureBatched(r, o, "BoundedQueue", bounded);
+
+  }
+
+} // namespace ZThread
@@ -28,6 +28,12 @@
 #include "zthread/Config.h"
 #include "zthread/NonCopyable.h"
 
+// Keep the count inline when the compiler provides atomic builtins
+#if defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)) \
+    && !defined(ZTHREAD_OUTOFLINE_ATOMIC_COUNT)
+#  define ZT_INLINE_ATOMIC_COUNT 1
+#endif
+
 namespace ZThread {
 
   /**
@@ -40,8 +46,46 @@ namespace ZThread {
    * incremented or decremented atomically. It's designed to be as simple and
    * lightweight as possible so that it can be used cheaply to create reference
    * counts.
+   *
+   * When the compiler provides atomic builtins the value is stored inline and
+   * each operation is a single atomic instruction. Otherwise the value lives 
+   * in the library, behind a pointer.
    */
   class ZTHREAD_API AtomicCount : public NonCopyable {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+    volatile size_t _value;
+
+  public:
+
+    //! Create a new AtomicCount
+    AtomicCount(size_t count) : _value(count) { }
+
+    //! Destroy a new AtomicCount
+    ~AtomicCount() { }
+  
+    //! Postfix decrement and return the previous value
+    size_t operator--(int) { 
+      return __sync_fetch_and_sub(&_value, 1); 
+    }
+  
+    //! Postfix increment and return the previous value
+    size_t operator++(int) {
+      return __sync_fetch_and_add(&_value, 1); 
+    }
+
+    //! Prefix decrement and return the current value
+    size_t operator--() {
+      return __sync_sub_and_fetch(&_value, 1); 
+    }
+  
+    //! Prefix increment and return the current value
+    size_t operator++() {
+      return __sync_add_and_fetch(&_value, 1); 
+    }
+
+#else
   
     void* _value;
   
@@ -65,6 +109,7 @@ namespace ZThread {
     //! Prefix increment and return the current value
     size_t operator++();  
 
+#endif
 
   }; /* AtomicCount */
 
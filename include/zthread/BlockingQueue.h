@@ -102,6 +102,108 @@ namespace ZThread {
 
       }
 
+#if defined(ZT_RVALUE_REFS)
+
+      /**
+       * @see Queue::add(T&& item)
+       */
+      virtual void add(T&& item) {
+
+        Guard<LockType> g(_lock);
+    
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.push_back(std::move(item));
+
+        _notEmpty.signal();
+
+      }
+
+      /**
+       * @see Queue::add(T&& item, unsigned long timeout)
+       */
+      virtual bool add(T&& item, unsigned long timeout) {
+
+        try {
+
+          Guard<LockType> g(_lock, timeout);
+      
+          if(_canceled)
+            throw Cancellation_Exception();
+      
+          _queue.push_back(std::move(item));
+
+          _notEmpty.signal();
+
+        } catch(Timeout_Exception&) { return false; }
+ 
+        return true;    
+
+      }
+
+      /**
+       * Construct a value in place at the end of this Queue.
+       *
+       * @param args arguments forwarded to the constructor of <i>T</i>
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a new value will have been added to the Queue.
+       */
+      template <class... Args>
+      void emplace(Args&&... args) {
+
+        Guard<LockType> g(_lock);
+    
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.emplace_back(std::forward<Args>(args)...);
+
+        _notEmpty.signal();
+
+      }
+
+#endif
+
+      /**
+       * Add a range of values to this Queue. The lock is acquired once for the whole
+       * range, and blocked threads are woken with a single signal or broadcast.
+       *
+       * @param first iterator to the first value to add
+       * @param last iterator past the last value to add
+       *
+       * @return <em>size_t</em> number of values added
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a copy of each value in the range will have been 
+       *       added to the Queue, in order.
+       */
+      template <class InputIterator>
+      size_t addAll(InputIterator first, InputIterator last) {
+
+        Guard<LockType> g(_lock);
+    
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        size_t n = 0;
+        for(; first != last; ++first, ++n)
+          _queue.push_back(*first);
+
+        if(n > 1)
+          _notEmpty.broadcast();
+        else if(n == 1)
+          _notEmpty.signal();
+
+        return n;
+
+      }
+
       /**
        * Get a value from this Queue. The calling thread may block indefinitely.
        *
@@ -127,7 +229,7 @@ namespace ZThread {
         if( _queue.size() == 0 )
           throw Cancellation_Exception();
         
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
     
         return item;
@@ -166,13 +268,88 @@ namespace ZThread {
         if(_queue.size() == 0 )
           throw Cancellation_Exception();
   
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
     
         return item;
 
       }
 
+      /**
+       * Get a value from this Queue, blocking the calling thread no later than the 
+       * given Deadline.
+       *
+       * @param deadline time after which this method will not block the calling thread.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Timeout_Exception thrown if the deadline passes before a value
+       *            can be retrieved.
+       *
+       * @see Queue::next(const Deadline& deadline)
+       */
+      virtual T next(const Deadline& deadline) {
+
+        Guard<LockType> g(_lock, deadline);
+
+        while(_queue.size() == 0 && !_canceled) {
+          if(!_notEmpty.wait(deadline))
+            throw Timeout_Exception();
+        }
+
+        if(_queue.size() == 0 )
+          throw Cancellation_Exception();
+  
+        T item(ZT_MOVE(_queue.front()));
+        _queue.pop_front();
+    
+        return item;
+
+      }
+
+
+      /**
+       * Remove up to <i>maxItems</i> values from this Queue, taking the lock once. The 
+       * calling thread is blocked until at least one value is available, or until the
+       * timeout expires.
+       *
+       * @param out output iterator the values are written to, in order
+       * @param maxItems largest number of values to remove
+       * @param timeout maximum amount of time (milliseconds) to wait for a value to
+       *        become available; 0 returns at once with whatever is available.
+       *
+       * @return <em>size_t</em> number of values removed, 0 if the timeout expired
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled and
+       *            is empty.
+       * @exception Interrupted_Exception thrown if the calling thread is interrupted
+       *            before a value becomes available.
+       */
+      template <class OutputIterator>
+      size_t drainTo(OutputIterator out, size_t maxItems, unsigned long timeout) {
+
+        Guard<LockType> g(_lock);
+
+        while(_queue.size() == 0 && !_canceled) {
+          if(timeout == 0 || !_notEmpty.wait(timeout))
+            return 0;
+        }
+
+        if( _queue.size() == 0 )
+          throw Cancellation_Exception();
+
+        size_t n = 0;
+        for(; n < maxItems && _queue.size() > 0; ++n) {
+
+          *out++ = ZT_MOVE(_queue.front());
+          _queue.pop_front();
+
+        }
+
+        return n;
+
+      }
 
       /**
        * @see Queue::cancel()
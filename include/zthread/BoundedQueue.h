@@ -180,6 +180,153 @@ namespace ZThread {
 
       }
 
+#if defined(ZT_RVALUE_REFS)
+
+      /**
+       * Move a value into this Queue, blocking while it is full.
+       *
+       * @see BoundedQueue::add(const T& item)
+       * @see Queue::add(T&& item)
+       */
+      virtual void add(T&& item) {
+        
+        Guard<LockType> g(_lock);
+        
+        // Wait for the capacity of the Queue to drop 
+        while ((_queue.size() == _capacity) && !_canceled)
+          _notFull.wait();
+      
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.push_back(std::move(item));
+        _notEmpty.signal(); // Wake any waiters
+    
+      }
+
+      /**
+       * Move a value into this Queue, blocking while it is full.
+       *
+       * @see BoundedQueue::add(const T& item, unsigned long timeout)
+       * @see Queue::add(T&& item, unsigned long timeout)
+       */
+      virtual bool add(T&& item, unsigned long timeout) {
+    
+        try {
+
+          Guard<LockType> g(_lock, timeout);
+      
+          // Wait for the capacity of the Queue to drop 
+          while ((_queue.size() == _capacity) && !_canceled)
+            if(!_notFull.wait(timeout))
+              return false;
+      
+          if(_canceled)
+            throw Cancellation_Exception();
+      
+          _queue.push_back(std::move(item));
+          _notEmpty.signal(); // Wake any waiters
+      
+        } catch(Timeout_Exception&) { return false; }
+    
+        return true;
+
+      }
+
+      /**
+       * Construct a value in place at the end of this Queue, blocking while it is full.
+       *
+       * @param args arguments forwarded to the constructor of <i>T</i>
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Interrupted_Exception thrown if the thread was interrupted while waiting
+       *            to add a value
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a new value will have been added to the Queue.
+       */
+      template <class... Args>
+      void emplace(Args&&... args) {
+        
+        Guard<LockType> g(_lock);
+        
+        // Wait for the capacity of the Queue to drop 
+        while ((_queue.size() == _capacity) && !_canceled)
+          _notFull.wait();
+      
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.emplace_back(std::forward<Args>(args)...);
+        _notEmpty.signal(); // Wake any waiters
+    
+      }
+
+#endif
+
+      /**
+       * Add a range of values to this Queue. The lock is acquired once for the whole
+       * range; values are inserted in as large a batch as the free capacity allows,
+       * and threads blocked in next() are woken once per batch.
+       *
+       * If the Queue fills before the range is exhausted, the calling thread will be 
+       * blocked until values are removed from the Queue. If the Queue is canceled 
+       * while the calling thread is blocked, the values already added remain in the 
+       * Queue and the rest of the range is not added.
+       *
+       * @param first iterator to the first value to add
+       * @param last iterator past the last value to add
+       * 
+       * @return <em>size_t</em> number of values added, less than the length of the 
+       *         range if the Queue was canceled part way through it
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled 
+       *            before any value was added.
+       * @exception Interrupted_Exception thrown if the thread was interrupted while waiting
+       *            to add a value; the values added before that remain in the Queue.
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post Each value that was added was copied to the Queue, in order.
+       */
+      template <class InputIterator>
+      size_t addAll(InputIterator first, InputIterator last) {
+        
+        Guard<LockType> g(_lock);
+
+        size_t added = 0;
+
+        while(first != last) {
+
+          // Wait for the capacity of the Queue to drop 
+          while ((_queue.size() == _capacity) && !_canceled)
+            _notFull.wait();
+      
+          if(_canceled) {
+
+            if(added == 0)
+              throw Cancellation_Exception();
+
+            break;
+
+          }
+
+          size_t n = 0;
+          for(; first != last && _queue.size() < _capacity; ++first, ++n)
+            _queue.push_back(*first);
+
+          if(n > 1)
+            _notEmpty.broadcast(); 
+          else
+            _notEmpty.signal();
+
+          added += n;
+
+        }
+
+        return added;
+    
+      }
+
       /**
        * Retrieve and remove a value from this Queue.
        *
@@ -205,7 +352,7 @@ namespace ZThread {
         if( _queue.size() == 0) // Queue canceled
           throw Cancellation_Exception();  
 
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
       
         _notFull.signal(); // Wake any thread trying to add
@@ -248,7 +395,46 @@ namespace ZThread {
         if(_queue.size() == 0)  // Queue canceled
           throw Cancellation_Exception();  
 
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
+        _queue.pop_front();
+
+        _notFull.signal(); // Wake add() waiters
+
+        if(_queue.size() == 0) // Wake empty() waiters
+          _isEmpty.broadcast();
+    
+        return item;
+    
+      }
+
+      /**
+       * Get a value from this Queue, blocking the calling thread no later than the 
+       * given Deadline.
+       *
+       * @param deadline time after which this method will not block the calling thread.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Timeout_Exception thrown if the deadline passes before a value
+       *            can be retrieved.
+       *
+       * @see Queue::next(const Deadline& deadline)
+       */
+      virtual T next(const Deadline& deadline) {
+      
+        Guard<LockType> g(_lock, deadline);
+    
+        // Wait for items to be added
+        while (_queue.size() == 0 && !_canceled) {
+          if(!_notEmpty.wait(deadline))
+            throw Timeout_Exception();
+        }
+
+        if(_queue.size() == 0)  // Queue canceled
+          throw Cancellation_Exception();  
+
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
 
         _notFull.signal(); // Wake add() waiters
@@ -260,6 +446,56 @@ namespace ZThread {
     
       }
 
+      /**
+       * Remove up to <i>maxItems</i> values from this Queue, taking the lock once. The 
+       * calling thread is blocked until at least one value is available, or until the
+       * timeout expires.
+       *
+       * @param out output iterator the values are written to, in order
+       * @param maxItems largest number of values to remove
+       * @param timeout maximum amount of time (milliseconds) to wait for a value to
+       *        become available; 0 returns at once with whatever is available.
+       *
+       * @return <em>size_t</em> number of values removed, 0 if the timeout expired
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled and
+       *            is empty.
+       * @exception Interrupted_Exception thrown if the calling thread is interrupted
+       *            before a value becomes available.
+       */
+      template <class OutputIterator>
+      size_t drainTo(OutputIterator out, size_t maxItems, unsigned long timeout) {
+
+        Guard<LockType> g(_lock);
+
+        while(_queue.size() == 0 && !_canceled) {
+          if(timeout == 0 || !_notEmpty.wait(timeout))
+            return 0;
+        }
+
+        if(_queue.size() == 0) // Queue canceled
+          throw Cancellation_Exception();  
+
+        size_t n = 0;
+        for(; n < maxItems && _queue.size() > 0; ++n) {
+
+          *out++ = ZT_MOVE(_queue.front());
+          _queue.pop_front();
+
+        }
+
+        if(n > 1) // Wake add() waiters
+          _notFull.broadcast();
+        else if(n == 1)
+          _notFull.signal();
+
+        if(_queue.size() == 0) // Wake empty() waiters
+          _isEmpty.broadcast();
+
+        return n;
+
+      }
+
       /**
        * Cancel this queue. 
        * 
@@ -274,6 +510,7 @@ namespace ZThread {
 
         _canceled = true;
         _notEmpty.broadcast(); // Wake next() waiters
+        _notFull.broadcast(); // Wake add() waiters
 
       }
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTCALLABLE_H__
+#define __ZTCALLABLE_H__
+
+#include "zthread/Config.h"
+
+namespace ZThread {
+
+  /**
+   * @class Callable
+   * 
+   * @version 2.3.3
+   *
+   * Encapsulates a task that produces a result. A Callable is to a Future 
+   * what a Runnable is to a Thread.
+   *
+   * @see Executor::submit()
+   */
+  template <class T>
+  class Callable {
+  public:
+
+    /**
+     * Callables should never throw in their destructors
+     */
+    virtual ~Callable() {}
+
+    /**
+     * Task to be performed in another thread of execution
+     *
+     * @return <em>T</em> result of the task
+     */
+    virtual T call() = 0;
+
+  };
+ 
+
+}
+
+#endif // __ZTCALLABLE_H__
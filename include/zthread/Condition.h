@@ -146,6 +146,28 @@ namespace ZThread {
      */
     virtual bool wait(unsigned long timeout);
 
+    /**
+     * Wait for this Condition, blocking the calling thread until a signal or broadcast
+     * is received, or until the given Deadline passes.
+     *
+     * @param deadline time after which the calling thread stops waiting
+     *
+     * @return 
+     *   - <em>true</em> if the Condition receives a signal or broadcast before 
+     *                   the deadline passes.
+     *   - <em>false</em> otherwise.
+     *   
+     * @exception Interrupted_Exception thrown when the calling thread is interrupted.
+     *
+     * @pre The thread calling this method must have first acquired the associated 
+     *      Lockable object. 
+     *
+     * @post the associated Lockable object is always acquire()d before returning.
+     *
+     * @see Waitable::wait(const Deadline& deadline)
+     */
+    virtual bool wait(const Deadline& deadline);
+
   
   };
   
@@ -72,6 +72,30 @@
 // Uncomment to select very simple spinlock based implementations
 // #define ZTHREAD_USE_SPIN_LOCKS 1
 
+// Uncomment to select the pthreads based FastLock and Monitor on Linux, instead 
+// of the ones built directly on futexes
+// #define ZTHREAD_DISABLE_FUTEX 1
+
+// Uncomment to look up the current thread through the POSIX thread specific storage
+// on every call, instead of caching it with the compiler's __thread storage
+// #define ZTHREAD_DISABLE_TLS 1
+
+// Uncomment to time waits against the wall-clock (gettimeofday/ftime), instead of
+// the POSIX monotonic clock, on systems that provide one
+// #define ZTHREAD_DISABLE_MONOTONIC_CLOCK 1
+
+// Uncomment to park a thread contending for a Mutex, PriorityMutex or (pthreads based) 
+// FastMutex right away, instead of spinning briefly while the owner releases it
+// #define ZTHREAD_DISABLE_ADAPTIVE_SPIN 1
+
+// Uncomment to keep the value of an AtomicCount in the library, instead of inline
+// atomic operations, even when the compiler provides atomic builtins. 
+// #define ZTHREAD_OUTOFLINE_ATOMIC_COUNT 1
+
+// Uncomment to leave out the rvalue reference overloads (add(T&&), emplace(), moving 
+// next()) of the Queue and CountedPtr templates when compiling as C++11 or later
+// #define ZTHREAD_DISABLE_RVALUE_REFS 1
+
 // Uncomment to select the vannila dual mutex implementation of FastRecursiveLock
 // #define ZTHREAD_DUAL_LOCKS 1
 
@@ -214,5 +238,15 @@
 #  define ZTHREAD_INLINE inline 
 #endif
 
+// Move values out of the Queue templates when the compiler understands rvalue references
+#if !defined(ZTHREAD_DISABLE_RVALUE_REFS) && \
+    (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800))
+#  define ZT_RVALUE_REFS 1
+#  include <utility>
+#  define ZT_MOVE(x) std::move(x)
+#else
+#  define ZT_MOVE(x) (x)
+#endif
+
 #endif // __ZTCONFIG_H__
 
@@ -98,6 +98,18 @@ namespace ZThread {
       }
 
 #endif
+#endif
+
+#if defined(ZT_RVALUE_REFS)
+
+      //! Take over the reference held by <i>ptr</i>, without touching the count
+      CountedPtr(CountedPtr&& ptr) : _count(ptr._count), _instance(ptr._instance) {
+
+        ptr._count = 0;
+        ptr._instance = 0;
+
+      }
+
 #endif
 
       ~CountedPtr() {
@@ -136,6 +148,19 @@ namespace ZThread {
       } 
 
 #endif
+#endif
+
+#if defined(ZT_RVALUE_REFS)
+
+      const CountedPtr& operator=(CountedPtr&& ptr) {
+    
+        typedef CountedPtr<T, CountT> ThisT;
+
+        ThisT(std::move(ptr)).swap(*this);
+        return *this;
+
+      } 
+
 #endif
 
       void reset() {
@@ -111,6 +111,21 @@ namespace ZThread {
      */
     virtual bool tryAcquire(unsigned long timeout);
 
+    /**
+     * Decrement the count, blocking that calling thread if the count becomes 0 or
+     * less than 0, no later than the given Deadline.
+     *
+     * @param deadline time after which this method will not block
+     * @return 
+     *   - <em>true</em> if the count was decremented
+     *   - <em>false</em> if the deadline passed first
+     *
+     * @exception Interrupted_Exception thrown when the calling thread is interrupted.
+     *
+     * @see Lockable::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline); 
+
     /**
      * Decrement the count, blocking that calling thread if the count becomes 0 or 
      * less than 0. The calling thread will remain blocked until the count is 
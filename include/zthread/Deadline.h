@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTDEADLINE_H__
+#define __ZTDEADLINE_H__
+
+#include "zthread/Config.h"
+
+namespace ZThread {
+
+/**
+ * @class Deadline
+ * @version 2.3.3
+ *
+ * A Deadline is an absolute point in time, measured with nanosecond resolution 
+ * against the same clock the library uses for its own timed waits. On systems that
+ * provide one, this is a monotonic clock, so a Deadline is not moved by changes 
+ * made to the wall-clock time.
+ *
+ * Because it is absolute, the same Deadline can be passed to several operations in
+ * turn (e.g. to acquire a lock and then to wait on a Condition) to bound the time 
+ * spent by all of them together.
+ *
+ * @code
+ * 
+ * // Wait no more than 250 microseconds for a value
+ * Deadline d(0, 250000);
+ * T value = queue.next(d);
+ *
+ * @endcode
+ */
+class ZTHREAD_API Deadline {
+
+  unsigned long _seconds;
+  unsigned long _nanoseconds;
+
+ public:
+
+  /**
+   * Create a Deadline for the current time; this Deadline has already
+   * expired.
+   */
+  Deadline();
+
+  /**
+   * Create a Deadline that expires some amount of time from now.
+   *
+   * @param secs - number of seconds from now
+   * @param nanos - number of nanoseconds, in addition to <i>secs</i>, from now
+   */
+  Deadline(unsigned long secs, unsigned long nanos);
+
+  /**
+   * Create a Deadline by copying another.
+   *
+   * @param d - Deadline object to copy.
+   */
+  Deadline(const Deadline& d)
+    : _seconds(d._seconds), _nanoseconds(d._nanoseconds) { }
+
+  /**
+   * Get the seconds part of the absolute time at which this Deadline expires.
+   *
+   * @return unsigned long seconds value
+   */
+  unsigned long seconds() const {
+    return _seconds;
+  }
+
+  /**
+   * Get the nanoseconds part of the absolute time at which this Deadline expires.
+   *
+   * @return unsigned long nanoseconds value, less than one second
+   */
+  unsigned long nanoseconds() const {
+    return _nanoseconds;
+  }
+
+  /**
+   * Test whether this Deadline has passed.
+   *
+   * @return bool true if the current time is at or after this Deadline
+   */
+  bool expired() const;
+
+  /**
+   * Get the time left before this Deadline expires.
+   *
+   * @param secs - set to the number of whole seconds left
+   * @param nanos - set to the number of nanoseconds left, in addition to <i>secs</i>
+   *
+   * @return bool false if this Deadline has expired, in which case both values are 0
+   */
+  bool remaining(unsigned long& secs, unsigned long& nanos) const;
+
+  /**
+   * Get the time left before this Deadline expires, rounded up to the next whole 
+   * millisecond. This is used to pass a Deadline to operations that only accept
+   * a timeout in milliseconds.
+   *
+   * @return unsigned long milliseconds left, or 0 if this Deadline has expired
+   */
+  unsigned long milliseconds() const;
+
+};
+
+} // namespace ZThread
+
+#endif // __ZTDEADLINE_H__
@@ -23,6 +23,7 @@
 #ifndef __ZTEXECUTOR_H__
 #define __ZTEXECUTOR_H__
 
+#include "zthread/FutureTask.h"
 #include "zthread/Thread.h"
 #include "zthread/Waitable.h"
 
@@ -61,7 +62,12 @@ namespace ZThread {
    * - <em>wait</em>()ing on a PoolExecutor will block the calling thread 
    *   until all tasks that were submitted prior to the invocation of this function
    *   have completed.
-   * 
+   *
+   * <b>Submitting</b>
+   *
+   * - <em>submit</em>()ing a Callable or a task executes it, returning a Future
+   *   for its result.
+   *
    * @see Cancelable
    * @see Waitable
    */
@@ -86,6 +92,66 @@ namespace ZThread {
      *            the invocation of this function.
      */
     virtual void execute(const Task& task) = 0;
+
+    /**
+     * Submit a Callable to this Executor, getting a Future for its result.
+     *
+     * @param callable Callable to be called by a thread managed by this executor 
+     *
+     * @return <em>Future<T></em> for the result of the Callable; it fails if the 
+     *         task is discarded without having run
+     *
+     * @exception Cancellation_Exception thrown if the Executor was canceled prior to
+     *            the invocation of this function.
+     *
+     * @see execute(const Task& task)
+     */
+    template <class T>
+    Future<T> submit(const CountedPtr< Callable<T>, AtomicCount >& callable) {
+
+      FutureTask<T>* raw = new FutureTask<T>(callable);
+      Task task(raw);
+
+      Future<T> future(raw->getFuture());
+      execute(task);
+
+      return future;
+
+    }
+
+    /**
+     * @see submit(const CountedPtr< Callable<T>, AtomicCount >& callable)
+     */
+    template <class T>
+    Future<T> submit(Callable<T>* callable) {
+      return submit(CountedPtr< Callable<T>, AtomicCount >(callable));
+    }
+
+    /**
+     * Submit a task to this Executor, getting a Future that is done once 
+     * the task has run.
+     *
+     * @param task Task to be run by a thread managed by this executor 
+     *
+     * @return <em>Future<void></em> for the completion of the task; it fails if 
+     *         the task is discarded without having run
+     *
+     * @exception Cancellation_Exception thrown if the Executor was canceled prior to
+     *            the invocation of this function.
+     *
+     * @see execute(const Task& task)
+     */
+    Future<void> submit(const Task& task) {
+
+      FutureTask<void>* raw = new FutureTask<void>(task);
+      Task wrapper(raw);
+
+      Future<void> future(raw->getFuture());
+      execute(wrapper);
+
+      return future;
+
+    }
   
   };
 
@@ -103,6 +103,17 @@ namespace ZThread {
      * @exception Interrupted_Exception never thrown
      */
     virtual bool tryAcquire(unsigned long timeout);
+
+    /**
+     * Acquire the FastMutex only if it is not already owned; like tryAcquire(unsigned long)
+     * this never blocks, whatever the Deadline.
+     *
+     * @param deadline ignored
+     * @return 
+     *   - <em>true</em> if the lock was acquired
+     *   - <em>false</em> if the lock was not acquired
+     */
+    virtual bool tryAcquire(const Deadline& deadline);
   
   }; /* FastMutex */
 
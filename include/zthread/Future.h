@@ -0,0 +1,882 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTFUTURE_H__
+#define __ZTFUTURE_H__
+
+#include "zthread/Cancelable.h"
+#include "zthread/Continuation.h"
+#include "zthread/CountedPtr.h"
+#include "zthread/Deadline.h"
+#include "zthread/Exceptions.h"
+#include "zthread/NonCopyable.h"
+#include "zthread/Runnable.h"
+#include "zthread/Waitable.h"
+
+#include <exception>
+#include <vector>
+
+namespace ZThread {
+
+  class Executor;
+  class FutureImpl;
+
+  /**
+   * @class CompletionTask
+   *
+   * @version 2.3.3
+   *
+   * A task that a Future schedules once it is done.
+   *
+   * @see FutureBase::whenDone()
+   */
+  class CompletionTask : public Runnable {
+  public:
+
+    virtual ~CompletionTask() {}
+
+    //! Called instead of run() when the Executor refuses the task
+    virtual void refused() = 0;
+
+  };
+
+  /**
+   * @class FutureBase
+   *
+   * @version 2.3.3
+   *
+   * The part of the state shared by a Future and its Promise that does not depend
+   * on the type of the result: whether the result is still pending, has been 
+   * published, has failed or has been canceled, and which threads are waiting 
+   * for it. 
+   *
+   * A waiting thread blocks on its own Monitor, and is woken directly when the 
+   * result is published. A Future needs no Mutex or Condition of its own.
+   */
+  class ZTHREAD_API FutureBase : private NonCopyable {
+
+    FutureImpl* _impl;
+
+  public:
+
+    /**
+     * Create a pending FutureBase
+     *
+     * @exception Initialization_Exception thrown if resources could not be 
+     *            allocated for this object.
+     */
+    FutureBase();
+
+    //! Destroy this FutureBase
+    virtual ~FutureBase();
+
+    /**
+     * Block until the result is published, has failed or has been canceled.
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting.
+     */
+    void wait();
+
+    /**
+     * Block until the result is published, has failed or has been canceled.
+     *
+     * @param timeout maximum amount of time, in milliseconds, to wait
+     *
+     * @return 
+     *   - <em>true</em> if the Future is done
+     *   - <em>false</em> if the timeout expired first
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting.
+     */
+    bool wait(unsigned long timeout);
+
+    /**
+     * Block until the result is published, has failed or has been canceled.
+     *
+     * @param deadline Deadline after which to stop waiting
+     *
+     * @return 
+     *   - <em>true</em> if the Future is done
+     *   - <em>false</em> if the deadline passed first
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting.
+     */
+    bool wait(const Deadline& deadline);
+
+    /**
+     * Cancel a pending result, waking any waiting threads.
+     *
+     * @return <em>true</em> if the result was still pending
+     */
+    bool cancel();
+
+    //! @return <em>true</em> if the result was canceled before it was published
+    bool isCanceled();
+
+    //! @return <em>true</em> if the result was published, failed or was canceled
+    bool isDone();
+
+    /**
+     * Fail a pending result, waking any waiting threads.
+     *
+     * @param reason message for the Future_Exception that get() will throw
+     *
+     * @return <em>true</em> if the result was still pending
+     */
+    bool fail(const char* reason);
+
+    //! Count another Promise that can publish this result
+    void addPromise();
+
+    /**
+     * Forget a Promise that can publish this result. A result that is still 
+     * pending fails once the last Promise for it is gone.
+     */
+    void removePromise();
+
+    /**
+     * Submit a task to an Executor once this Future is done, or at once if it is 
+     * done already. No thread is kept waiting in the meantime. If the Executor 
+     * has been canceled, the task is refused() instead.
+     *
+     * @param executor Executor that runs the task; it must outlive this Future, or 
+     *        be used before this Future is destroyed.
+     * @param task CompletionTask to schedule
+     */
+    void whenDone(Executor& executor, const CountedPtr<CompletionTask, AtomicCount>& task);
+
+    /**
+     * Run a task once this Future is done, in the thread that completes it, or 
+     * in the calling thread if it is done already. The task should be short, 
+     * and must not block.
+     *
+     * @param task CompletionTask to run
+     */
+    void whenDone(const CountedPtr<CompletionTask, AtomicCount>& task);
+
+  protected:
+
+    /**
+     * Reserve a pending result for the calling thread, so that it can be stored
+     * before it is publish()ed.
+     *
+     * @return <em>false</em> if the result is no longer pending
+     */
+    bool claim();
+
+    //! Wake the threads waiting for a result that was claim()ed
+    void publish();
+
+    //! Fail a result that was claim()ed, but could not be stored
+    void abandon(const char* reason);
+
+    /**
+     * Check the outcome of a Future that is done.
+     *
+     * @exception Cancellation_Exception thrown if the result was canceled
+     * @exception Future_Exception thrown if the result failed
+     */
+    void check();
+
+  };
+
+
+  /**
+   * @class FutureState
+   *
+   * @version 2.3.3
+   *
+   * State shared by a Future and its Promise, holding the result once it
+   * is published.
+   */
+  template <class T>
+  class FutureState : public FutureBase {
+
+    T* _value;
+
+  public:
+
+    FutureState() : _value(0) {}
+
+    virtual ~FutureState() {
+      delete _value;
+    }
+
+    //! Publish the result, unless it is no longer pending
+    bool set(const T& value) {
+
+      if(!claim())
+        return false;
+
+      try {
+
+        _value = new T(value);
+
+      } catch(...) {
+
+        abandon("Result could not be stored");
+        throw;
+
+      }
+
+      publish();
+      return true;
+
+    }
+
+    T get() {
+
+      wait();
+      check();
+
+      return *_value;
+
+    }
+
+    template <class Timeout>
+    T get(const Timeout& timeout) {
+
+      if(!wait(timeout))
+        throw Timeout_Exception();
+
+      check();
+
+      return *_value;
+
+    }
+
+  };
+
+  /**
+   * @class FutureState<void>
+   *
+   * State shared by a Future and its Promise, when there is no result to hold.
+   */
+  template <>
+  class FutureState<void> : public FutureBase {
+  public:
+
+    //! Publish completion, unless it is no longer pending
+    bool set() {
+
+      if(!claim())
+        return false;
+
+      publish();
+      return true;
+
+    }
+
+    void get() {
+
+      wait();
+      check();
+
+    }
+
+    template <class Timeout>
+    void get(const Timeout& timeout) {
+
+      if(!wait(timeout))
+        throw Timeout_Exception();
+
+      check();
+
+    }
+
+  };
+
+
+  /**
+   * @class Future
+   *
+   * @version 2.3.3
+   *
+   * A Future is a handle to the result of a task, which is published through a Promise
+   * once the task has completed. Any number of threads can wait for the same result.
+   * Copies of a Future refer to the same result.
+   *
+   * @code
+   *
+   * Future<int> answer = executor.submit(new Compute);
+   *
+   * // ...
+   *
+   * int n = answer.get();
+   *
+   * @endcode
+   *
+   * <b>Canceling</b>
+   *
+   * - <em>cancel</em>()ing a Future that is still pending wakes the threads waiting for
+   *   it; get() throws a Cancellation_Exception from then on. A task that has not started
+   *   yet is skipped. A task that is already running is not interrupted, and its result
+   *   is discarded.
+   *
+   * @see Promise
+   * @see Executor::submit()
+   */
+  template <class T>
+  class Future : public Waitable, public Cancelable {
+
+    CountedPtr< FutureState<T>, AtomicCount > _state;
+
+  public:
+
+    //! Create a Future that does not refer to any result yet
+    Future() {}
+
+    //! Create a Future for the given state
+    Future(const CountedPtr< FutureState<T>, AtomicCount >& state) : _state(state) {}
+
+    //! Destroy this Future
+    virtual ~Future() {}
+
+    /**
+     * Get the result, blocking until it is published.
+     *
+     * @return <em>T</em> the result
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting.
+     * @exception Cancellation_Exception thrown if the Future was canceled.
+     * @exception Future_Exception thrown if the task failed.
+     */
+    T get() {
+      return _state->get();
+    }
+
+    /**
+     * Get the result, blocking until it is published or the timeout expires.
+     *
+     * @param timeout maximum amount of time, in milliseconds, to wait
+     *
+     * @return <em>T</em> the result
+     *
+     * @exception Timeout_Exception thrown if the timeout expires first.
+     *
+     * @see get()
+     */
+    T get(unsigned long timeout) {
+      return _state->get(timeout);
+    }
+
+    /**
+     * Get the result, blocking until it is published or the deadline passes.
+     *
+     * @param deadline Deadline after which to stop waiting
+     *
+     * @return <em>T</em> the result
+     *
+     * @exception Timeout_Exception thrown if the deadline passes first.
+     *
+     * @see get()
+     */
+    T get(const Deadline& deadline) {
+      return _state->get(deadline);
+    }
+
+    /**
+     * Block until the result is published, has failed or has been canceled.
+     *
+     * @see Waitable::wait()
+     */
+    virtual void wait() {
+      _state->wait();
+    }
+
+    /**
+     * @see Waitable::wait(unsigned long timeout)
+     */
+    virtual bool wait(unsigned long timeout) {
+      return _state->wait(timeout);
+    }
+
+    /**
+     * @see Waitable::wait(const Deadline& deadline)
+     */
+    virtual bool wait(const Deadline& deadline) {
+      return _state->wait(deadline);
+    }
+
+    /**
+     * @see Cancelable::cancel()
+     */
+    virtual void cancel() {
+      _state->cancel();
+    }
+
+    /**
+     * @see Cancelable::isCanceled()
+     */
+    virtual bool isCanceled() {
+      return _state->isCanceled();
+    }
+
+    //! @return <em>true</em> if the result was published, failed or was canceled
+    bool isDone() {
+      return _state->isDone();
+    }
+
+    /**
+     * Submit a Continuation to an Executor once this Future is done. If this Future 
+     * failed or was canceled, the get() the Continuation makes throws, failing or 
+     * canceling the Future that is returned.
+     *
+     * @param executor Executor that runs the Continuation
+     * @param continuation Continuation to call with this Future
+     *
+     * @return <em>Future<R></em> for the result of the Continuation; it is canceled 
+     *         if the Executor has been canceled when this Future is done.
+     *
+     * @see FutureBase::whenDone()
+     */
+    template <class R>
+    Future<R> then(Executor& executor, const CountedPtr< Continuation<T, R>, AtomicCount >& continuation);
+
+    /**
+     * @see then(Executor& executor, const CountedPtr< Continuation<T, R>, AtomicCount >& continuation)
+     */
+    template <class R>
+    Future<R> then(Executor& executor, Continuation<T, R>* continuation) {
+      return then(executor, CountedPtr< Continuation<T, R>, AtomicCount >(continuation));
+    }
+
+    //! @see FutureBase::whenDone()
+    void whenDone(Executor& executor, const CountedPtr<CompletionTask, AtomicCount>& task) {
+      _state->whenDone(executor, task);
+    }
+
+    //! @see FutureBase::whenDone()
+    void whenDone(const CountedPtr<CompletionTask, AtomicCount>& task) {
+      _state->whenDone(task);
+    }
+
+  };
+
+
+  /**
+   * @class Promise
+   *
+   * @version 2.3.3
+   *
+   * A Promise publishes the result that its Future is waiting for. Copies of a 
+   * Promise refer to the same result; only the first result published is kept.
+   *
+   * Once every copy of a Promise has been destroyed without publishing a result, 
+   * its Future fails, since nothing is left to publish it.
+   *
+   * @see Future
+   */
+  template <class T>
+  class Promise {
+
+    CountedPtr< FutureState<T>, AtomicCount > _state;
+
+  public:
+
+    //! Create a Promise for a new, pending result
+    Promise() : _state(new FutureState<T>()) {
+      _state->addPromise();
+    }
+
+    //! Create a Promise for the same result as another
+    Promise(const Promise& promise) : _state(promise._state) {
+      _state->addPromise();
+    }
+
+    //! Destroy this Promise, failing a pending result if it was the last copy
+    ~Promise() {
+      _state->removePromise();
+    }
+
+    //! Refer to the same result as another Promise
+    Promise& operator=(const Promise& promise) {
+
+      if(&promise != this) {
+
+        _state->removePromise();
+
+        _state = promise._state;
+        _state->addPromise();
+
+      }
+
+      return *this;
+
+    }
+
+    //! @return <em>Future<T></em> waiting for the result of this Promise
+    Future<T> getFuture() const {
+      return Future<T>(_state);
+    }
+
+    /**
+     * Publish the result, waking the threads waiting for it.
+     *
+     * @param value result
+     *
+     * @return <em>false</em> if a result was already published or failed, or the
+     *         Future was canceled.
+     */
+    bool setValue(const T& value) {
+      return _state->set(value);
+    }
+
+    /**
+     * Fail the result; get() will throw a Future_Exception.
+     *
+     * @param reason message for the Future_Exception
+     *
+     * @return <em>false</em> if a result was already published or failed, or the
+     *         Future was canceled.
+     */
+    bool fail(const char* reason = "Future failed") {
+      return _state->fail(reason);
+    }
+
+    //! @return <em>true</em> if the Future was canceled; the result is no longer needed
+    bool isCanceled() {
+      return _state->isCanceled();
+    }
+
+  };
+
+  /**
+   * @class Promise<void>
+   *
+   * A Promise that publishes completion, without a result.
+   */
+  template <>
+  class Promise<void> {
+
+    CountedPtr< FutureState<void>, AtomicCount > _state;
+
+  public:
+
+    Promise() : _state(new FutureState<void>()) {
+      _state->addPromise();
+    }
+
+    Promise(const Promise& promise) : _state(promise._state) {
+      _state->addPromise();
+    }
+
+    ~Promise() {
+      _state->removePromise();
+    }
+
+    Promise& operator=(const Promise& promise) {
+
+      if(&promise != this) {
+
+        _state->removePromise();
+
+        _state = promise._state;
+        _state->addPromise();
+
+      }
+
+      return *this;
+
+    }
+
+    Future<void> getFuture() const {
+      return Future<void>(_state);
+    }
+
+    //! @see Promise::setValue()
+    bool setValue() {
+      return _state->set();
+    }
+
+    //! @see Promise::fail()
+    bool fail(const char* reason = "Future failed") {
+      return _state->fail(reason);
+    }
+
+    //! @see Promise::isCanceled()
+    bool isCanceled() {
+      return _state->isCanceled();
+    }
+
+  };
+
+
+  /**
+   * @class ThenTask
+   *
+   * @version 2.3.3
+   *
+   * CompletionTask that calls a Continuation with the Future it was attached to, 
+   * publishing the result through a Promise.
+   *
+   * @see Future::then()
+   */
+  template <class T, class R>
+  class ThenTask : public CompletionTask {
+
+    Future<T> _antecedent;
+    CountedPtr< Continuation<T, R>, AtomicCount > _continuation;
+    Promise<R> _promise;
+
+  public:
+
+    ThenTask(const Future<T>& antecedent, const CountedPtr< Continuation<T, R>, AtomicCount >& continuation)
+      : _antecedent(antecedent), _continuation(continuation) { }
+
+    virtual ~ThenTask() { }
+
+    Future<R> getFuture() const {
+      return _promise.getFuture();
+    }
+
+    virtual void run() {
+
+      if(_promise.isCanceled())
+        return;
+
+      try {
+
+        _promise.setValue(_continuation->call(_antecedent));
+
+      } catch(Cancellation_Exception&) {
+        refused();
+      } catch(Synchronization_Exception& e) {
+        _promise.fail(e.what());
+      } catch(std::exception& e) {
+        _promise.fail(e.what());
+      } catch(...) {
+        _promise.fail("Task failed");
+      }
+
+    }
+
+    virtual void refused() {
+      _promise.getFuture().cancel();
+    }
+
+  };
+
+  /**
+   * @class ThenTask<T, void>
+   *
+   * CompletionTask for a Continuation without a result.
+   */
+  template <class T>
+  class ThenTask<T, void> : public CompletionTask {
+
+    Future<T> _antecedent;
+    CountedPtr< Continuation<T, void>, AtomicCount > _continuation;
+    Promise<void> _promise;
+
+  public:
+
+    ThenTask(const Future<T>& antecedent, const CountedPtr< Continuation<T, void>, AtomicCount >& continuation)
+      : _antecedent(antecedent), _continuation(continuation) { }
+
+    virtual ~ThenTask() { }
+
+    Future<void> getFuture() const {
+      return _promise.getFuture();
+    }
+
+    virtual void run() {
+
+      if(_promise.isCanceled())
+        return;
+
+      try {
+
+        _continuation->call(_antecedent);
+        _promise.setValue();
+
+      } catch(Cancellation_Exception&) {
+        refused();
+      } catch(Synchronization_Exception& e) {
+        _promise.fail(e.what());
+      } catch(std::exception& e) {
+        _promise.fail(e.what());
+      } catch(...) {
+        _promise.fail("Task failed");
+      }
+
+    }
+
+    virtual void refused() {
+      _promise.getFuture().cancel();
+    }
+
+  };
+
+  template <class T>
+  template <class R>
+  Future<R> Future<T>::then(Executor& executor, const CountedPtr< Continuation<T, R>, AtomicCount >& continuation) {
+
+    ThenTask<T, R>* raw = new ThenTask<T, R>(*this, continuation);
+    CountedPtr<CompletionTask, AtomicCount> task(raw);
+
+    Future<R> future(raw->getFuture());
+    _state->whenDone(executor, task);
+
+    return future;
+
+  }
+
+
+  /**
+   * @class WhenAllTask
+   *
+   * @version 2.3.3
+   *
+   * CompletionTask attached to every Future given to whenAll(). The last one to 
+   * run publishes the Futures. whenAll() runs it once more itself, after it has 
+   * been attached to all of them.
+   */
+  template <class T>
+  class WhenAllTask : public CompletionTask {
+
+    std::vector< Future<T> > _futures;
+    AtomicCount _remaining;
+    Promise< std::vector< Future<T> > > _promise;
+
+  public:
+
+    WhenAllTask(const std::vector< Future<T> >& futures) 
+      : _futures(futures), _remaining(futures.size() + 1) { }
+
+    virtual ~WhenAllTask() { }
+
+    Future< std::vector< Future<T> > > getFuture() const {
+      return _promise.getFuture();
+    }
+
+    virtual void run() {
+
+      if(--_remaining == 0)
+        _promise.setValue(_futures);
+
+    }
+
+    virtual void refused() { }
+
+  };
+
+  /**
+   * Combine several Futures into one, that is done once all of them are. None of 
+   * them failing or being canceled affects the result; the Futures are published 
+   * as they are, to be examined by whoever receives them.
+   *
+   * @param futures Futures to wait for
+   *
+   * @return <em>Future< std::vector< Future<T> > ></em> for the same Futures, once 
+   *         all of them are done.
+   *
+   * @see Future::then()
+   */
+  template <class T>
+  Future< std::vector< Future<T> > > whenAll(const std::vector< Future<T> >& futures) {
+
+    WhenAllTask<T>* raw = new WhenAllTask<T>(futures);
+    CountedPtr<CompletionTask, AtomicCount> task(raw);
+
+    Future< std::vector< Future<T> > > future(raw->getFuture());
+
+    for(typename std::vector< Future<T> >::const_iterator i = futures.begin(); i != futures.end(); ++i) {
+      Future<T> f(*i);
+      f.whenDone(task);
+    }
+
+    raw->run();
+
+    return future;
+
+  }
+
+  /**
+   * @class WhenAnyTask
+   *
+   * @version 2.3.3
+   *
+   * CompletionTask attached to one of the Futures given to whenAny(). The 
+   * first one to run publishes its Future.
+   */
+  template <class T>
+  class WhenAnyTask : public CompletionTask {
+
+    Future<T> _future;
+    Promise< Future<T> > _promise;
+
+  public:
+
+    WhenAnyTask(const Future<T>& future, const Promise< Future<T> >& promise) 
+      : _future(future), _promise(promise) { }
+
+    virtual ~WhenAnyTask() { }
+
+    virtual void run() {
+      _promise.setValue(_future);
+    }
+
+    virtual void refused() { }
+
+  };
+
+  /**
+   * Combine several Futures into one, that is done as soon as any of them is. 
+   *
+   * @param futures Futures to wait for
+   *
+   * @return <em>Future< Future<T> ></em> for the first of the Futures to be done. It 
+   *         fails if there are no Futures.
+   *
+   * @see Future::then()
+   */
+  template <class T>
+  Future< Future<T> > whenAny(const std::vector< Future<T> >& futures) {
+
+    Promise< Future<T> > promise;
+
+    if(futures.empty())
+      promise.fail("No futures to wait for");
+
+    for(typename std::vector< Future<T> >::const_iterator i = futures.begin(); i != futures.end(); ++i) {
+
+      Future<T> f(*i);
+      f.whenDone(CountedPtr<CompletionTask, AtomicCount>(new WhenAnyTask<T>(f, promise)));
+
+      // The rest need not be watched once one is done
+      if(f.isDone())
+        break;
+
+    }
+
+    return promise.getFuture();
+
+  }
+
+} // namespace ZThread
+
+#endif // __ZTFUTURE_H__
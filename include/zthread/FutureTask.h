@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTFUTURETASK_H__
+#define __ZTFUTURETASK_H__
+
+#include "zthread/Callable.h"
+#include "zthread/Future.h"
+#include "zthread/Task.h"
+
+#include <exception>
+
+namespace ZThread {
+
+  /**
+   * @class FutureTask
+   *
+   * @version 2.3.3
+   *
+   * A FutureTask is a Runnable that calls a Callable and publishes its result 
+   * through a Promise. If the Future was canceled before the FutureTask runs, the 
+   * Callable is not called. An exception thrown by the Callable fails the Future,
+   * and so does destroying a FutureTask that never ran.
+   *
+   * @see Executor::submit()
+   */
+  template <class T>
+  class FutureTask : public Runnable {
+
+    CountedPtr< Callable<T>, AtomicCount > _callable;
+    Promise<T> _promise;
+
+  public:
+
+    FutureTask(const CountedPtr< Callable<T>, AtomicCount >& callable) 
+      : _callable(callable) { }
+
+    //! Fail the Future if this task never ran
+    virtual ~FutureTask() { 
+      _promise.fail("Task was not run");
+    }
+
+    //! @return <em>Future<T></em> waiting for the result of this task
+    Future<T> getFuture() const {
+      return _promise.getFuture();
+    }
+
+    virtual void run() {
+
+      if(_promise.isCanceled())
+        return;
+
+      try {
+
+        _promise.setValue(_callable->call());
+
+      } catch(Synchronization_Exception& e) {
+        _promise.fail(e.what());
+      } catch(std::exception& e) {
+        _promise.fail(e.what());
+      } catch(...) {
+        _promise.fail("Task failed");
+      }
+
+    }
+
+  };
+
+  /**
+   * @class FutureTask<void>
+   *
+   * A FutureTask for a Callable without a result, or for a Runnable.
+   */
+  template <>
+  class FutureTask<void> : public Runnable {
+
+    //! @class RunnableCallable
+    class RunnableCallable : public Callable<void> {
+
+      Task _task;
+
+    public:
+
+      RunnableCallable(const Task& task) : _task(task) { }
+
+      virtual void call() {
+        _task->run();
+      }
+
+    };
+
+    CountedPtr< Callable<void>, AtomicCount > _callable;
+    Promise<void> _promise;
+
+  public:
+
+    FutureTask(const CountedPtr< Callable<void>, AtomicCount >& callable) 
+      : _callable(callable) { }
+
+    FutureTask(const Task& task) 
+      : _callable(new RunnableCallable(task)) { }
+
+    virtual ~FutureTask() { 
+      _promise.fail("Task was not run");
+    }
+
+    //! @see FutureTask::getFuture()
+    Future<void> getFuture() const {
+      return _promise.getFuture();
+    }
+
+    virtual void run() {
+
+      if(_promise.isCanceled())
+        return;
+
+      try {
+
+        _callable->call();
+        _promise.setValue();
+
+      } catch(Synchronization_Exception& e) {
+        _promise.fail(e.what());
+      } catch(std::exception& e) {
+        _promise.fail(e.what());
+      } catch(...) {
+        _promise.fail("Task failed");
+      }
+
+    }
+
+  };
+
+} // namespace ZThread
+
+#endif // __ZTFUTURETASK_H__
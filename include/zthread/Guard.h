@@ -23,6 +23,8 @@
 #ifndef __ZTGUARD_H__
 #define __ZTGUARD_H__
 
+#include "zthread/Deadline.h"
+#include "zthread/Lockable.h"
 #include "zthread/NonCopyable.h"
 #include "zthread/Exceptions.h"
 
@@ -33,6 +35,7 @@ namespace ZThread {
 //
 // createScope(lock_type&)
 // bool createScope(lock_type&, unsigned long)
+// bool createScope(lock_type&, const Deadline&) (optional)
 // destroyScope(lock_type&)
 //
 // }
@@ -172,6 +175,20 @@ class LockedScope {
 
   }
 
+  /**
+   * A new protection scope is being created, no later than the given deadline.
+   *
+   * @param lock LockType& is a type of LockHolder.
+   */
+  template <class LockType>
+  static bool createScope(LockHolder<LockType>& l, const Deadline& deadline) {
+
+    // Go through the Lockable interface, so that a lock which only overrides
+    // tryAcquire(unsigned long) still offers the default tryAcquire(const Deadline&)
+    return static_cast<Lockable&>(l.getLock()).tryAcquire(deadline);
+
+  }
+
   /**
    * A new protection scope is being created.
    *
@@ -417,6 +434,26 @@ public:
 
   };
 
+  /**
+   * Create a Guard that enforces a the effective protection scope
+   * throughout the lifetime of the Guard object or until the protection
+   * scope is modified by another Guard.
+   *
+   * @param lock LockType the lock this Guard will use to enforce its
+   * protection scope.
+   * @param deadline Deadline after which the Guard stops trying to create 
+   * its protection scope.
+   *
+   * @exception Timeout_Exception thrown if the deadline passes first
+   * @post the protection scope may be ended prematurely
+   */
+  Guard(LockType& lock, const Deadline& deadline) : LockHolder<LockType>(lock) {
+
+    if(!LockingPolicy::createScope(*this, deadline))
+      throw Timeout_Exception();
+
+  };
+
   /**
    * Create a Guard that shares the effective protection scope
    * from the given Guard to this Guard.
@@ -23,6 +23,7 @@
 #ifndef __ZTLOCKABLE_H__
 #define __ZTLOCKABLE_H__
 
+#include "zthread/Deadline.h"
 #include "zthread/Exceptions.h"
 
 namespace ZThread { 
@@ -77,6 +78,30 @@ namespace ZThread {
      * @post The Lockable is acquired only if no exception was thrown. 
      */
     virtual bool tryAcquire(unsigned long timeout) = 0;
+
+    /** 
+     * Attempt to acquire the Lockable object, blocking no later than the given 
+     * Deadline.
+     *
+     * Specializations that can block with a finer resolution override this method;
+     * by default the time left before the Deadline is rounded up to the next 
+     * millisecond and passed to tryAcquire(unsigned long).
+     *
+     * @param deadline - time after which this method will not block
+     *
+     * @return 
+     *   - <em>true</em>  if the operation completes and the Lockable is acquired before 
+     *     the deadline passes. 
+     *   - <em>false</em> if the deadline passes before the Lockable can be acquired.
+     * 
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted before
+     *            the operation completes.
+     *
+     * @post The Lockable is acquired only if no exception was thrown. 
+     */
+    virtual bool tryAcquire(const Deadline& deadline) {
+      return tryAcquire(deadline.milliseconds());
+    }
   
     /** 
      * Release the Lockable object.
@@ -93,6 +93,66 @@ namespace ZThread {
 
       }
 
+#if defined(ZT_RVALUE_REFS)
+
+      /**
+       * @see Queue::add(T&& item)
+       */
+      virtual void add(T&& item) {
+
+        Guard<LockType> g(_lock);
+    
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.push_back(std::move(item));
+
+      }
+
+      /**
+       * @see Queue::add(T&& item, unsigned long timeout)
+       */
+      virtual bool add(T&& item, unsigned long timeout) {
+
+        try {
+
+          Guard<LockType> g(_lock, timeout);
+      
+          if(_canceled)
+            throw Cancellation_Exception();
+      
+          _queue.push_back(std::move(item));
+
+        } catch(Timeout_Exception&) { return false; }
+ 
+        return true;    
+
+      }
+
+      /**
+       * Construct a value in place at the end of this Queue.
+       *
+       * @param args arguments forwarded to the constructor of <i>T</i>
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a new value will have been added to the Queue.
+       */
+      template <class... Args>
+      void emplace(Args&&... args) {
+
+        Guard<LockType> g(_lock);
+    
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        _queue.emplace_back(std::forward<Args>(args)...);
+
+      }
+
+#endif
+
       /**
        * @see Queue::next()
        */
@@ -106,7 +166,7 @@ namespace ZThread {
         if(_queue.size() == 0)
           throw NoSuchElement_Exception();
 
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
     
         return item;
@@ -127,7 +187,38 @@ namespace ZThread {
         if(_queue.size() == 0)
           throw NoSuchElement_Exception();
 
-        T item = _queue.front();
+        T item(ZT_MOVE(_queue.front()));
+        _queue.pop_front();
+      
+        return item;
+      
+      }
+
+      /**
+       * Get a value from this Queue, blocking the calling thread no later than the 
+       * given Deadline.
+       *
+       * @param deadline time after which this method will not block the calling thread.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Timeout_Exception thrown if the deadline passes before a value
+       *            can be retrieved.
+       *
+       * @see Queue::next(const Deadline& deadline)
+       */
+      virtual T next(const Deadline& deadline) {
+
+        Guard<LockType> g(_lock, deadline);
+
+        if(_queue.size() == 0 && _canceled)
+          throw Cancellation_Exception();
+    
+        if(_queue.size() == 0)
+          throw NoSuchElement_Exception();
+
+        T item(ZT_MOVE(_queue.front()));
         _queue.pop_front();
       
         return item;
@@ -29,6 +29,7 @@
 namespace ZThread { 
   
   class FifoMutexImpl;
+  class RequeueTarget;
 
   /**
    * @class Mutex
@@ -58,6 +59,9 @@ namespace ZThread {
   class ZTHREAD_API Mutex : public Lockable, private NonCopyable {
   
     FifoMutexImpl* _impl;
+
+    //! Lets a Condition move its waiters onto this mutex
+    friend class RequeueTarget;
   
   public:
 
@@ -112,6 +116,24 @@ namespace ZThread {
      * @see Lockable::tryAcquire(unsigned long timeout)
      */
     virtual bool tryAcquire(unsigned long timeout);
+
+    /**
+     * Acquire a Mutex, possibly blocking until the current owner of the 
+     * Mutex releases it, until an exception is thrown or until the given 
+     * Deadline passes.
+     *
+     * @param deadline time after which this method will not block
+     * @return 
+     * - <em>true</em> if the lock was acquired
+     * - <em>false</em> if the deadline passed first
+     *
+     * @exception Interrupted_Exception thrown when the calling thread is interrupted.
+     * @exception Deadlock_Exception thrown when the same thread attempts to acquire
+     *            a Mutex more than once, without having first released it.
+     *
+     * @see Lockable::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline);
   
     /**
      * Release a Mutex allowing another thread to acquire it.
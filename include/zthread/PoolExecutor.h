@@ -36,7 +36,7 @@ namespace ZThread {
    *
    * @author Eric Crahen <http://www.code-foo.com>
    * @date <2003-07-16T22:41:07-0400>
-   * @version 2.3.0
+   * @version 2.3.3
    *
    * A PoolExecutor spawns a set of threads that are used to run tasks 
    * that are submitted in parallel. A PoolExecutor supports the following
@@ -52,6 +52,17 @@ namespace ZThread {
    * - <em>wait</em>()ing on a PoolExecutor will block the calling thread 
    *   until all tasks that were submitted prior to the invocation of this function
    *   have completed.
+   *
+   * A PoolExecutor can be created in a <i>work stealing</i> mode, STEALING. Tasks submitted from 
+   * outside the PoolExecutor go into a shared queue, while tasks submitted by a task 
+   * that is running in the PoolExecutor are kept by the thread running it. Threads that 
+   * run out of work steal tasks from each other before blocking on the shared queue.
+   * This scales better when tasks spawn other tasks. 
+   *
+   * A PoolExecutor can also be <i>elastic</i>, keeping between a minimum and a maximum 
+   * number of threads. Another thread is started when a task is queued while there are
+   * more queued tasks than idle threads, and the maximum has not been reached. Threads
+   * above the minimum exit after they have been idle for a keep alive time.
    * 
    * @see Executor.
    */
@@ -64,13 +75,40 @@ namespace ZThread {
     Task _shutdown;
 
   public:
+
+    //! How queued tasks are shared among the threads
+    typedef enum {
+
+      //! Every task goes through a single shared queue
+      SHARED,
+
+      //! Each thread keeps the tasks it submits, idle threads steal them
+      STEALING
+
+    } QueueMode;
     
     /**
      * Create a PoolExecutor
      *
      * @param n number of threads to service tasks with
+     * @param mode how queued tasks are shared among the threads
+     */
+    PoolExecutor(size_t n, QueueMode mode = SHARED);
+
+    /**
+     * Create an elastic PoolExecutor
+     *
+     * @param min number of threads to keep even when there is no work
+     * @param max largest number of threads to service tasks with
+     * @param keepAlive time, in milliseconds, that a thread above the minimum 
+     *        waits for a task before it exits. 0 keeps threads until the 
+     *        PoolExecutor is canceled.
+     * @param mode how queued tasks are shared among the threads
+     *
+     * @exception InvalidOp_Exception thrown if <i>min</i> is less than 1, or 
+     *            <i>max</i> is less than <i>min</i>.
      */
-    PoolExecutor(size_t n);
+    PoolExecutor(size_t min, size_t max, unsigned long keepAlive, QueueMode mode = SHARED);
 
     //! Destroy a PoolExecutor
     virtual ~PoolExecutor();
@@ -89,6 +127,9 @@ namespace ZThread {
 
     /**
      * Alter the number of threads being used to execute submitted tasks.
+     * For an elastic PoolExecutor this sets the minimum number of threads, 
+     * raising the maximum if it is smaller. Threads beyond the new size exit 
+     * once they finish the task they are running.
      * 
      * @param n number of worker threads.
      *
@@ -101,7 +142,8 @@ namespace ZThread {
     void size(size_t n);
         
     /**
-     * Get the current number of threads being used to execute submitted tasks.
+     * Get the current number of threads being used to execute submitted tasks,
+     * including those that are starting.
      *
      * @return n number of worker threads.
      */
@@ -81,6 +81,11 @@ namespace ZThread {
      * @see Condition::wait(unsigned long timeout)
      */
     virtual bool wait(unsigned long timeout);
+
+    /**
+     * @see Condition::wait(const Deadline& deadline)
+     */
+    virtual bool wait(const Deadline& deadline);
   
   };
   
@@ -79,6 +79,11 @@ namespace ZThread {
      * @see Mutex::tryAcquire(unsigned long timeout)
      */
     virtual bool tryAcquire(unsigned long timeout); 
+
+    /**
+     * @see Mutex::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline); 
   
     /**
      * @see Mutex::release()
@@ -29,6 +29,7 @@
 namespace ZThread { 
   
   class PriorityMutexImpl;
+  class RequeueTarget;
 
   /**
    * @class PriorityMutex
@@ -50,6 +51,9 @@ namespace ZThread {
   class ZTHREAD_API PriorityMutex : public Lockable, private NonCopyable {
   
     PriorityMutexImpl* _impl;
+
+    //! Lets a Condition move its waiters onto this mutex
+    friend class RequeueTarget;
   
   public:
 
@@ -72,6 +76,11 @@ namespace ZThread {
      * @see Mutex::tryAcquire(unsigned long timeout)
      */
     virtual bool tryAcquire(unsigned long timeout); 
+
+    /**
+     * @see Mutex::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline); 
   
     /**
      * @see Mutex::release()
@@ -93,6 +93,11 @@ namespace ZThread {
      */
     virtual bool tryAcquire(unsigned long timeout);
 
+    /**
+     * @see Semaphore::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline);
+
     /**
      * @see Semaphore::acquire()
      */
@@ -24,6 +24,7 @@
 #define __ZTQUEUE_H__
 
 #include "zthread/Cancelable.h"
+#include "zthread/Deadline.h"
 #include "zthread/NonCopyable.h"
 
 namespace ZThread {
@@ -75,6 +76,45 @@ namespace ZThread {
      */
     virtual bool add(const T& item, unsigned long timeout) = 0;
 
+#if defined(ZT_RVALUE_REFS)
+
+    /**
+     * Move an object into this Queue. Implementations that can store <i>item</i> 
+     * without copying it override this; by default a copy is added.
+     *
+     * @param item value to be moved into the Queue
+     * 
+     * @exception Cancellation_Exception thrown if this Queue has been canceled.
+     *
+     * @see Queue::add(const T& item)
+     */
+    virtual void add(T&& item) {
+      add(static_cast<const T&>(item));
+    }
+
+    /**
+     * Move an object into this Queue. Implementations that can store <i>item</i> 
+     * without copying it override this; by default a copy is added.
+     *
+     * @param item value to be moved into the Queue
+     * @param timeout maximum amount of time (milliseconds) this method may block
+     *        the calling thread.
+     *
+     * @return 
+     *   - <em>true</em> if <i>item</i> can be added before <i>timeout</i> 
+     *     milliseconds elapse.
+     *   - <em>false</em> otherwise, <i>item</i> is left unchanged.
+     *
+     * @exception Cancellation_Exception thrown if this Queue has been canceled.
+     *
+     * @see Queue::add(const T& item, unsigned long timeout)
+     */
+    virtual bool add(T&& item, unsigned long timeout) {
+      return add(static_cast<const T&>(item), timeout);
+    }
+
+#endif
+
     /**
      * Retrieve and remove a value from this Queue.
      *
@@ -104,6 +144,29 @@ namespace ZThread {
      */
     virtual T next(unsigned long timeout) = 0;
 
+    /**
+     * Retrieve and remove a value from this Queue, blocking no later than the given
+     * Deadline.
+     *
+     * Specializations that can block with a finer resolution override this method;
+     * by default the time left before the Deadline is rounded up to the next 
+     * millisecond and passed to next(unsigned long).
+     *
+     * @param deadline time after which this method will not block the calling thread.
+     *
+     * @return <em>T</em> next available value
+     * 
+     * @exception Cancellation_Exception thrown if this Queue has been canceled.
+     * @exception Timeout_Exception thrown if the deadline passes before a value
+     *            can be retrieved.
+     *
+     * @pre  The Queue should not have been canceled prior to the invocation of this function.
+     * @post The value returned will have been removed from the Queue.
+     */
+    virtual T next(const Deadline& deadline) {
+      return next(deadline.milliseconds());
+    }
+
     /**
      * Canceling a Queue disables it, disallowing further additions. Values already
      * present in the Queue can still be retrieved and are still available through
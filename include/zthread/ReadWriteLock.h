@@ -40,6 +40,8 @@ namespace ZThread {
    *
    * @see BiasedReadWriteLock
    * @see FairReadWriteLock
+   * @see StripedReadWriteLock
+   * @see UpgradableReadWriteLock
    */  
   class ReadWriteLock : public NonCopyable {
   public:
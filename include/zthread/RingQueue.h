@@ -0,0 +1,605 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTRINGQUEUE_H__
+#define __ZTRINGQUEUE_H__
+
+#include "zthread/AtomicCount.h"
+#include "zthread/Condition.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Guard.h"
+#include "zthread/Queue.h"
+
+namespace ZThread {
+
+  /**
+   * @class RingQueue
+   *
+   * @version 2.3.3
+   *
+   * A RingQueue is a bounded Queue that does not serialize producers and consumers
+   * through a lock. Values are stored in a fixed size ring, and each slot of that ring 
+   * carries a sequence number that tells producers and consumers whose turn it is to 
+   * use the slot. An add() or next() claims a slot with a single compare and swap.
+   *
+   * - Threads calling the next() methods will be blocked until the RingQueue has a value 
+   *   to return. 
+   * - Threads calling the add() methods will be blocked until there is room in the 
+   *   RingQueue for another value.
+   *
+   * Threads only touch a lock when they have to block because the RingQueue is empty or 
+   * full, or when they need to wake such a thread.
+   *
+   * The values stored in a RingQueue must be default constructible and assignable. The 
+   * slots are default constructed when the RingQueue is created, and a slot is reset to 
+   * a default constructed value when a value is removed.
+   *
+   * Without atomic builtins the slots are claimed under a short lock instead, which 
+   * still keeps that lock apart from the one blocked threads wait under.
+   *
+   * @see Queue
+   */
+  template <class T>
+    class RingQueue : public Queue<T> {
+
+      //! Storage for a single value
+      struct Slot {
+
+        volatile size_t sequence;
+        T value;
+
+      };
+
+      //! Keep the producer and consumer positions on separate cache lines
+      enum { PADDING = 64 };
+
+      //! Storage backing the queue
+      Slot* _ring;
+
+      //! Number of slots minus one, the number of slots is a power of two
+      size_t _mask;
+
+      char _pad0[PADDING];
+
+      //! Position of the next add()
+      volatile size_t _addPos;
+
+      char _pad1[PADDING];
+
+      //! Position of the next next()
+      volatile size_t _nextPos;
+
+      char _pad2[PADDING];
+
+      //! Serialize blocking threads
+      FastMutex _lock;
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+      //! Serialize claiming slots
+      FastMutex _ringLock;
+#endif
+
+      //! Signaled if not full
+      Condition _notFull;
+
+      //! Signaled if not empty
+      Condition _notEmpty;
+
+      //! Threads blocked in add()
+      volatile int _addWaiters;
+
+      //! Threads blocked in next()
+      volatile int _nextWaiters;
+
+      //! Cancellation flag
+      volatile bool _canceled;
+
+      public:
+
+      /**
+       * Create a RingQueue with at least the given capacity. The capacity is rounded up 
+       * to the next power of two.
+       * 
+       * @param capacity minimum number of values to allow in the Queue at any time
+       */
+      RingQueue(size_t capacity) 
+        : _notFull(_lock), _notEmpty(_lock), _addWaiters(0), _nextWaiters(0), _canceled(false) {
+
+        size_t n = 2;
+        while(n < capacity)
+          n <<= 1;
+
+        _ring = new Slot[n];
+        _mask = n - 1;
+
+        for(size_t i = 0; i < n; ++i)
+          _ring[i].sequence = i;
+
+        _addPos = _nextPos = 0;
+
+      }
+
+      //! Destroy this Queue
+      virtual ~RingQueue() { 
+        delete[] _ring;
+      }
+
+      /**
+       * Get the maximum capacity of this Queue. 
+       *
+       * @return <i>size_t</i> maximum capacity
+       */
+      size_t capacity() { 
+        return _mask + 1; 
+      }
+
+      /**
+       * Add a value to this Queue. 
+       *
+       * If the Queue is full, the calling thread will be blocked until at least one 
+       * value is removed from the Queue.
+       *
+       * @param item value to be added to the Queue
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Interrupted_Exception thrown if the thread was interrupted while waiting
+       *            to add a value
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a copy of <i>item</i> will have been added to the Queue.
+       *
+       * @see Queue::add(const T& item)
+       */
+      virtual void add(const T& item) {
+
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        if(!push(item)) {
+
+          Guard<FastMutex> g(_lock);
+          Waiting w(_addWaiters);
+
+          // Wait for a value to be removed
+          while(!push(item)) {
+
+            if(_canceled)
+              throw Cancellation_Exception();
+
+            _notFull.wait();
+
+          }
+
+        }
+
+        wake(_nextWaiters, _notEmpty);
+
+      }
+
+      /**
+       * Add a value to this Queue. 
+       *
+       * If the Queue is full, the calling thread will be blocked until at least one 
+       * value is removed from the Queue.
+       *
+       * @param item value to be added to the Queue
+       * @param timeout maximum amount of time (milliseconds) this method may block
+       *        the calling thread.
+       *
+       * @return 
+       *   - <em>true</em> if a copy of <i>item</i> can be added before <i>timeout</i> 
+       *     milliseconds elapse.
+       *   - <em>false</em> otherwise.
+       *
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Interrupted_Exception thrown if the thread was interrupted while waiting
+       *            to add a value
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post If no exception is thrown, a copy of <i>item</i> will have been added to the Queue.
+       *
+       * @see Queue::add(const T& item, unsigned long timeout)
+       */
+      virtual bool add(const T& item, unsigned long timeout) {
+
+        if(_canceled)
+          throw Cancellation_Exception();
+
+        if(!push(item)) {
+
+          try {
+
+            Guard<FastMutex> g(_lock, timeout);
+            Waiting w(_addWaiters);
+
+            // Wait for a value to be removed
+            while(!push(item)) {
+
+              if(_canceled)
+                throw Cancellation_Exception();
+
+              if(!_notFull.wait(timeout))
+                return false;
+
+            }
+
+          } catch(Timeout_Exception&) { return false; }
+
+        }
+
+        wake(_nextWaiters, _notEmpty);
+
+        return true;
+
+      }
+
+      /**
+       * Retrieve and remove a value from this Queue.
+       *
+       * If invoked when there are no values present to return then the calling thread 
+       * will be blocked until a value arrives in the Queue.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Interrupted_Exception thrown if the thread was interrupted while waiting
+       *            to retrieve a value
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post The value returned will have been removed from the Queue.
+       */
+      virtual T next() {
+
+        T item;
+
+        if(!pop(item)) {
+
+          Guard<FastMutex> g(_lock);
+          Waiting w(_nextWaiters);
+
+          // Wait for a value to be added
+          while(!pop(item)) {
+
+            if(_canceled) // Queue canceled
+              throw Cancellation_Exception();
+
+            _notEmpty.wait();
+
+          }
+
+        }
+
+        wake(_addWaiters, _notFull);
+
+        return item;
+
+      }
+
+      /**
+       * Retrieve and remove a value from this Queue.
+       *
+       * If invoked when there are no values present to return then the calling thread 
+       * will be blocked until a value arrives in the Queue.
+       *
+       * @param timeout maximum amount of time (milliseconds) this method may block
+       *        the calling thread.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Timeout_Exception thrown if the timeout expires before a value
+       *            can be retrieved.
+       *
+       * @pre  The Queue should not have been canceled prior to the invocation of this function.
+       * @post The value returned will have been removed from the Queue.
+       */
+      virtual T next(unsigned long timeout) {
+
+        T item;
+
+        if(!pop(item)) {
+
+          Guard<FastMutex> g(_lock, timeout);
+          Waiting w(_nextWaiters);
+
+          // Wait for a value to be added
+          while(!pop(item)) {
+
+            if(_canceled) // Queue canceled
+              throw Cancellation_Exception();
+
+            if(!_notEmpty.wait(timeout))
+              throw Timeout_Exception();
+
+          }
+
+        }
+
+        wake(_addWaiters, _notFull);
+
+        return item;
+
+      }
+
+      /**
+       * Get a value from this Queue, blocking the calling thread no later than the 
+       * given Deadline.
+       *
+       * @param deadline time after which this method will not block the calling thread.
+       *
+       * @return <em>T</em> next available value
+       * 
+       * @exception Cancellation_Exception thrown if this Queue has been canceled.
+       * @exception Timeout_Exception thrown if the deadline passes before a value
+       *            can be retrieved.
+       *
+       * @see Queue::next(const Deadline& deadline)
+       */
+      virtual T next(const Deadline& deadline) {
+
+        T item;
+
+        if(!pop(item)) {
+
+          Guard<FastMutex> g(_lock, deadline);
+          Waiting w(_nextWaiters);
+
+          // Wait for a value to be added
+          while(!pop(item)) {
+
+            if(_canceled) // Queue canceled
+              throw Cancellation_Exception();
+
+            if(!_notEmpty.wait(deadline))
+              throw Timeout_Exception();
+
+          }
+
+        }
+
+        wake(_addWaiters, _notFull);
+
+        return item;
+
+      }
+
+      /**
+       * Cancel this queue. 
+       * 
+       * @post Any threads blocked by an add() function will throw a Cancellation_Exception.
+       * @post Any threads blocked by a next() function will throw a Cancellation_Exception.
+       * 
+       * @see Queue::cancel()
+       */
+      virtual void cancel() {
+
+        Guard<FastMutex> g(_lock);
+
+        _canceled = true;
+
+        _notEmpty.broadcast(); // Wake next() waiters
+        _notFull.broadcast();  // Wake add() waiters
+
+      }
+
+      /**
+       * @see Queue::isCanceled()
+       */
+      virtual bool isCanceled() {
+        return _canceled;
+      }
+
+      /**
+       * Get the number of values in this Queue. The result is a snapshot, and may 
+       * already be out of date when it is returned.
+       *
+       * @see Queue::size()
+       */
+      virtual size_t size() {
+
+        size_t n = _nextPos;
+        size_t m = _addPos;
+
+        return m > n ? m - n : 0;
+
+      }
+
+      /**
+       * @see Queue::size(unsigned long timeout)
+       */
+      virtual size_t size(unsigned long) {
+        return size();
+      }
+
+      private:
+
+      //! Count a blocked thread for as long as it holds the lock
+      class Waiting {
+
+        volatile int& _count;
+
+      public:
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+        Waiting(volatile int& count) : _count(count) { 
+          __sync_fetch_and_add(&_count, 1);
+        }
+
+        ~Waiting() { 
+          __sync_fetch_and_sub(&_count, 1);
+        }
+
+#else
+
+        // Only changed under _lock, and ordered by _ringLock in push() and pop()
+        Waiting(volatile int& count) : _count(count) { 
+          ++_count;
+        }
+
+        ~Waiting() { 
+          --_count;
+        }
+
+#endif
+
+      };
+
+      //! Wake a blocked thread if there is one
+      void wake(volatile int& waiters, Condition& cond) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+        // Order the slot update before the check, a thread that has
+        // not been counted yet is guaranteed to see the update
+        __sync_synchronize();
+#endif
+
+        if(waiters > 0) {
+
+          Guard<FastMutex> g(_lock);
+          cond.signal();
+
+        }
+
+      }
+
+      //! Claim a free slot and store a value, false if the Queue is full
+      bool push(const T& item) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+        size_t pos = _addPos;
+        Slot* slot;
+
+        for(;;) {
+
+          slot = &_ring[pos & _mask];
+          long d = (long)(slot->sequence - pos);
+
+          if(d == 0) {
+
+            size_t found = __sync_val_compare_and_swap(&_addPos, pos, pos + 1);
+            if(found == pos)
+              break;
+
+            pos = found;
+
+          } else if(d < 0)
+            return false;
+          else
+            pos = _addPos;
+
+        }
+
+        slot->value = item;
+
+        // Publish the value to next()
+        __sync_synchronize();
+        slot->sequence = pos + 1;
+
+        return true;
+
+#else
+
+        Guard<FastMutex> g(_ringLock);
+
+        size_t pos = _addPos;
+        Slot& slot = _ring[pos & _mask];
+
+        if(slot.sequence != pos)
+          return false;
+
+        slot.value = item;
+        slot.sequence = pos + 1;
+
+        _addPos = pos + 1;
+
+        return true;
+
+#endif
+
+      }
+
+      //! Claim a full slot and retrieve its value, false if the Queue is empty
+      bool pop(T& item) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+        size_t pos = _nextPos;
+        Slot* slot;
+
+        for(;;) {
+
+          slot = &_ring[pos & _mask];
+          long d = (long)(slot->sequence - (pos + 1));
+
+          if(d == 0) {
+
+            size_t found = __sync_val_compare_and_swap(&_nextPos, pos, pos + 1);
+            if(found == pos)
+              break;
+
+            pos = found;
+
+          } else if(d < 0)
+            return false;
+          else
+            pos = _nextPos;
+
+        }
+
+        item = ZT_MOVE(slot->value);
+        slot->value = T();
+
+        // Hand the slot back to add()
+        __sync_synchronize();
+        slot->sequence = pos + _mask + 1;
+
+        return true;
+
+#else
+
+        Guard<FastMutex> g(_ringLock);
+
+        size_t pos = _nextPos;
+        Slot& slot = _ring[pos & _mask];
+
+        if(slot.sequence != pos + 1)
+          return false;
+
+        item = ZT_MOVE(slot.value);
+        slot.value = T();
+        slot.sequence = pos + _mask + 1;
+
+        _nextPos = pos + 1;
+
+        return true;
+
+#endif
+
+      }
+
+    }; /* RingQueue */
+
+} // namespace ZThread
+
+#endif // __ZTRINGQUEUE_H__
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTSEQLOCK_H__
+#define __ZTSEQLOCK_H__
+
+#include "zthread/AtomicCount.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Guard.h"
+#include "zthread/Lockable.h"
+#include "zthread/NonCopyable.h"
+#include "zthread/Thread.h"
+
+namespace ZThread {
+
+  /**
+   * @class SeqLock
+   *
+   * @version 2.3.3
+   *  
+   * A SeqLock guards a small value that is read very often and written rarely, such as
+   * a snapshot of a few fields or a set of counters. Readers never write to shared 
+   * memory: a read copies the value optimistically and checks a sequence number, which
+   * writers make odd while they update the value, to see whether the copy must be retried.
+   * Readers therefore never block writers and do not bounce cache lines between each 
+   * other.
+   *
+   * Writers are serialized by the <i>LockType</i>, a FastMutex by default. The SeqLock is
+   * the Lockable writers use, so it can be given to a Guard while the value is updated 
+   * in place:
+   *
+   * @code
+   *
+   * SeqLock<Quote> quote;
+   *
+   * // Writer
+   * {
+   *   Guard<SeqLock<Quote> > g(quote);
+   *   quote.value().bid = bid;
+   *   quote.value().ask = ask;
+   * }
+   *
+   * // Reader
+   * Quote q = quote.read();
+   *
+   * @endcode
+   *
+   * A reader may copy the value while a writer is changing it, and throws that copy away
+   * when it notices. <i>T</i> should therefore be a plain data type, whose copy constructor
+   * and assignment do not follow pointers or allocate.
+   *
+   * When the compiler provides no atomic builtins, readers acquire the <i>LockType</i> as 
+   * well; reads are then serialized, but still consistent.
+   */
+  template <class T, class LockType = FastMutex>
+  class SeqLock : public Lockable, private NonCopyable {
+
+    //! Spins while a write is in progress before a reader yields
+    enum { MAX_SPINS = 100 };
+
+    mutable LockType _lock;
+    volatile unsigned long _sequence;
+    T _value;
+
+  public:
+
+    //! Create a SeqLock holding a default constructed value
+    SeqLock() : _sequence(0), _value() { }
+
+    //! Create a SeqLock holding the given value
+    SeqLock(const T& value) : _sequence(0), _value(value) { }
+
+    //! Destroy this SeqLock
+    virtual ~SeqLock() { }
+
+    /**
+     * Get a consistent copy of the value, retrying for as long as writers are
+     * changing it.
+     *
+     * @return <em>T</em> copy of the value
+     */
+    T read() const {
+
+      T value;
+
+      for(int n = 0; !tryRead(value); ++n) {
+
+        // Let a writer that was preempted in the middle of an update finish it
+        if(n < MAX_SPINS) {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+          __asm__ __volatile__("pause" ::: "memory");
+#endif
+        } else {
+
+          Thread::yield();
+          n = 0;
+
+        }
+
+      }
+
+      return value;
+
+    }
+
+    /**
+     * Make a single attempt to copy the value.
+     *
+     * @param value set to a copy of the value; only meaningful if the attempt succeeds
+     *
+     * @return 
+     *   - <em>true</em> if the copy is consistent
+     *   - <em>false</em> if a writer was changing the value at the same time
+     */
+    bool tryRead(T& value) const {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+      unsigned long s = begin();
+      if(s & 1)
+        return false;
+
+      value = _value;
+      
+      return validate(s);
+
+#else
+
+      Guard<LockType> g(_lock);
+      value = _value;
+
+      return true;
+
+#endif
+
+    }
+
+    /**
+     * Replace the value.
+     *
+     * @param value new value
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting for another writer.
+     */
+    void write(const T& value) {
+
+      Guard<SeqLock> g(*this);
+      _value = value;
+
+    }
+
+    /**
+     * Get the value, to update it in place. 
+     *
+     * @return <em>T&</em> the value
+     *
+     * @pre the calling thread has acquired this SeqLock
+     */
+    T& value() {
+      return _value;
+    }
+
+    /**
+     * Begin a write, serializing with other writers. Readers retry until 
+     * the write ends.
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting for another writer.
+     *
+     * @see Lockable::acquire()
+     */
+    virtual void acquire() {
+
+      _lock.acquire();
+      enter();
+
+    }
+
+    /**
+     * @see Lockable::tryAcquire(unsigned long timeout)
+     */
+    virtual bool tryAcquire(unsigned long timeout) {
+
+      if(!_lock.tryAcquire(timeout))
+        return false;
+
+      enter();
+      return true;
+
+    }
+
+    /**
+     * @see Lockable::tryAcquire(const Deadline& deadline)
+     */
+    virtual bool tryAcquire(const Deadline& deadline) {
+
+      if(!static_cast<Lockable&>(_lock).tryAcquire(deadline))
+        return false;
+
+      enter();
+      return true;
+
+    }
+
+    /**
+     * End a write, publishing the new value to readers.
+     *
+     * @see Lockable::release()
+     */
+    virtual void release() {
+
+      leave();
+      _lock.release();
+
+    }
+
+  private:
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+    //! Read the sequence number, ordering the reads of the value after it
+    unsigned long begin() const {
+
+#if defined(__ATOMIC_ACQUIRE)
+      return __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE);
+#else
+      unsigned long s = _sequence;
+      __sync_synchronize();
+
+      return s;
+#endif
+
+    }
+
+    //! Check that the sequence number did not change while the value was read
+    bool validate(unsigned long s) const {
+
+#if defined(__ATOMIC_ACQUIRE)
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      return __atomic_load_n(&_sequence, __ATOMIC_RELAXED) == s;
+#else
+      __sync_synchronize();
+      return _sequence == s;
+#endif
+
+    }
+
+    //! Make the sequence number odd, ordered before the writes to the value
+    void enter() {
+
+#if defined(__ATOMIC_RELEASE)
+      __atomic_store_n(&_sequence, _sequence + 1, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+      _sequence = _sequence + 1;
+      __sync_synchronize();
+#endif
+
+    }
+
+    //! Make the sequence number even again, ordered after the writes to the value
+    void leave() {
+
+#if defined(__ATOMIC_RELEASE)
+      __atomic_store_n(&_sequence, _sequence + 1, __ATOMIC_RELEASE);
+#else
+      __sync_synchronize();
+      _sequence = _sequence + 1;
+#endif
+
+    }
+
+#else
+
+    // Readers hold the lock, there is nothing for them to check
+    void enter() { }
+
+    void leave() { }
+
+#endif
+
+  };
+
+} // namespace ZThread
+
+#endif // __ZTSEQLOCK_H__
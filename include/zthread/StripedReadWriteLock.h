@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTSTRIPEDREADWRITELOCK_H__
+#define __ZTSTRIPEDREADWRITELOCK_H__
+
+#include "zthread/ReadWriteLock.h"
+
+namespace ZThread {
+
+  class StripedReadWriteLockImpl;
+
+  /**
+   * @class StripedReadWriteLock
+   *
+   * @version 2.3.3
+   *  
+   * A StripedReadWriteLock is built for data that is read very often and written 
+   * rarely. Readers do not share a lock, or even a single counter: each thread 
+   * counts itself in on one of several stripes, spread over separate cache lines,
+   * so readers running on different processors do not contend with each other. 
+   * Acquiring or releasing the read-only Lockable is a single atomic update when no
+   * writer is active.
+   *
+   * The cost is moved to the writers. A writer announces itself, which turns new 
+   * readers away, and then waits for every stripe to drain before it is granted 
+   * read-write access. Writers are serialized with each other in FIFO order.
+   *
+   * <b>Scheduling</b>
+   *
+   * An announced writer is preferred over arriving readers, so that a steady stream 
+   * of readers cannot starve it. As with the BiasedReadWriteLock, a thread must not 
+   * acquire the read-only Lockable again while it already holds it; if a writer 
+   * announces itself in between, the two would deadlock.
+   *
+   * @see ReadWriteLock 
+   * @see BiasedReadWriteLock 
+   */
+  class ZTHREAD_API StripedReadWriteLock : public ReadWriteLock {
+
+    StripedReadWriteLockImpl* _impl;
+
+  public:
+  
+    /**
+     * Create a StripedReadWriteLock, with a number of stripes based on the number 
+     * of processors available.
+     *
+     * @exception Initialization_Exception thrown if resources could not be 
+     *            allocated for this object.
+     */
+    StripedReadWriteLock();
+
+    /**
+     * Create a StripedReadWriteLock
+     *
+     * @param stripes number of reader stripes, rounded up to a power of 2
+     *
+     * @exception Initialization_Exception thrown if resources could not be 
+     *            allocated for this object.
+     */
+    StripedReadWriteLock(unsigned int stripes);
+
+    //! Destroy this ReadWriteLock
+    virtual ~StripedReadWriteLock();
+
+    /**
+     * @see ReadWriteLock::getReadLock()
+     */
+    virtual Lockable& getReadLock();
+
+    /**
+     * @see ReadWriteLock::getWriteLock()
+     */
+    virtual Lockable& getWriteLock();
+
+  };
+
+} // namespace ZThread
+
+#endif // __ZTSTRIPEDREADWRITELOCK_H__
@@ -63,6 +63,13 @@ namespace ZThread {
     template <typename U, typename V>
       Task(const CountedPtr<U, V>& ptr) 
       : CountedPtr<Runnable, AtomicCount>(ptr) { } 
+
+#if defined(ZT_RVALUE_REFS)
+
+    Task(CountedPtr<Runnable, AtomicCount>&& ptr) 
+      : CountedPtr<Runnable, AtomicCount>(std::move(ptr)) { } 
+
+#endif
     
     void operator()() {
       (*this)->run();
@@ -31,11 +31,24 @@ namespace ZThread {
    * @class ThreadLocalImpl
    * @author Eric Crahen <http://www.code-foo.com>
    * @date <2003-07-27T10:23:19-0400>
-   * @version 2.3.0
+   * @version 2.3.3
+   *
+   * Each ThreadLocalImpl is given a small index when it is created. Every thread keeps 
+   * its values in a vector of slots, so finding the value for a ThreadLocal is an 
+   * indexed load. Indices are reused once a ThreadLocalImpl is destroyed, a slot also
+   * records a serial number unique to the ThreadLocalImpl that filled it so that a
+   * value left behind is never mistaken for the value of a newer ThreadLocal.
    *
    * @see ThreadLocal
    */
   class ZTHREAD_API ThreadLocalImpl : private NonCopyable {   
+
+    //! Position of this ThreadLocal's value in each thread's slots
+    size_t _index;
+
+    //! Identifies the values that belong to this ThreadLocal
+    size_t _serial;
+
   public:
 
     class Value;
@@ -91,8 +104,8 @@ namespace ZThread {
 
   protected:
 
-    //! Get the Value for the current thread
-    ValuePtr value( ValuePtr (*pfn)() ) const;
+    //! Get the Value for the current thread, the thread keeps the reference to it
+    Value* value( ValuePtr (*pfn)() ) const;
 
     //! Clear any value set for this thread
     void clear() const;
@@ -35,9 +35,16 @@ namespace ZThread {
    *
    * @author Eric Crahen <http://www.code-foo.com>
    * @date <2003-07-16T22:39:13-0400>
-   * @version 2.3.0
+   * @version 2.3.3
    *
    * A ThreadedExecutor spawns a new thread to execute each task submitted.
+   *
+   * A ThreadedExecutor can be created with a keep alive time, in which case a thread 
+   * that finishes its task waits up to that long for another task before it exits. 
+   * Tasks submitted while there are idle threads are handed to one of them instead of 
+   * starting a new thread. Each task still runs as a thread of its own; a task handed to 
+   * an idle thread gets a new identity, with its own interrupted status and the ThreadLocal
+   * values inherited from the thread submitting it, just as a new thread would.
    * A ThreadedExecutor supports the following optional operations,
    *
    * - <em>cancel</em>()ing a ThreadedExecutor will cause it to stop accepting 
@@ -62,7 +69,21 @@ namespace ZThread {
     //! Create a new ThreadedExecutor
     ThreadedExecutor();
 
-    //! Destroy a ThreadedExecutor
+    /**
+     * Create a new ThreadedExecutor that reuses threads.
+     *
+     * A task handed to a reused thread runs as a thread of its own: it sees its own 
+     * Thread::current() and interrupted status, and takes the ThreadLocal values and 
+     * the priority a new thread started by the submitting thread would have. That 
+     * identity is a reference thread, so it can not be joined.
+     *
+     * @param keepAlive time, in milliseconds, that a thread which has completed 
+     *        its task waits for another one before exiting. 0 disables the reuse 
+     *        of threads.
+     */
+    ThreadedExecutor(unsigned long keepAlive);
+
+    //! Destroy a ThreadedExecutor, letting any idle threads exit
     virtual ~ThreadedExecutor();
 
     /**
@@ -75,8 +96,8 @@ namespace ZThread {
     
     /**
      * Submit a task to this Executor. This will not block the current thread 
-     * for very long. A new thread will be created and the task will be run()
-     * within the context of that new thread.
+     * for very long. A new thread will be created, or an idle one reused, and 
+     * the task will be run() within the context of that thread.
      * 
      * @exception Cancellation_Exception thrown if this Executor has been canceled.
      * The Task being submitted will not be executed by this Executor.
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTUPGRADABLEREADWRITELOCK_H__
+#define __ZTUPGRADABLEREADWRITELOCK_H__
+
+#include "zthread/ReadWriteLock.h"
+#include "zthread/Condition.h"
+#include "zthread/Deadline.h"
+#include "zthread/Exceptions.h"
+#include "zthread/Guard.h"
+#include "zthread/FastMutex.h"
+
+namespace ZThread {
+
+  /**
+   * @class UpgradableReadWriteLock
+   *
+   * @version 2.3.3
+   *  
+   * An UpgradableReadWriteLock adds a third, upgradable, Lockable to the pair a 
+   * ReadWriteLock provides. The upgradable lock is held by one thread at a time; it 
+   * shares access with readers and excludes writers. Its holder can upgrade() to
+   * read-write access without giving up access in between, so nothing it read
+   * can change before it writes. No other thread can upgrade while it holds the 
+   * upgradable lock, so the upgrade cannot fail because another thread upgraded first.
+   *
+   * A thread holding the write lock can also downgrade() to the upgradable lock, or
+   * downgradeToRead(), letting readers in without another writer getting ahead of it.
+   *
+   * Like the BiasedReadWriteLock, this lock has a bias toward writers: once a writer is
+   * waiting, new readers and upgraders wait behind it. An upgrade in progress holds
+   * back new readers as well.
+   *
+   * @code
+   *
+   * Guard<Lockable> g(rwlock.getUpgradableLock());
+   *
+   * if(!cache.contains(key)) {
+   *
+   *   Guard<UpgradableReadWriteLock, UpgradedScope> w(rwlock);
+   *   cache.insert(key, load(key));
+   *
+   * }
+   *
+   * @endcode
+   *
+   * A thread that holds the read lock must not acquire the upgradable lock as well; 
+   * an upgrade would then wait on that thread forever.
+   *
+   * @see ReadWriteLock 
+   * @see UpgradedScope
+   * @see DowngradedScope
+   */
+  class UpgradableReadWriteLock : public ReadWriteLock {
+
+    FastMutex _lock;
+    Condition _condRead;
+    Condition _condWrite;
+    Condition _condUpgrade;
+
+    volatile int _activeReaders;
+    volatile bool _activeWriter;
+    volatile bool _activeUpgrader;
+    volatile bool _upgrading;
+
+    volatile int _waitingWriters;
+
+    //! @class ReadLock
+    class ReadLock : public Lockable {
+
+      UpgradableReadWriteLock& _rwlock;
+
+    public:
+
+      ReadLock(UpgradableReadWriteLock& rwlock) : _rwlock(rwlock) {}
+
+      virtual ~ReadLock() {}
+
+      virtual void acquire() {
+        _rwlock.beforeRead(0);
+      }
+
+      virtual bool tryAcquire(unsigned long timeout) {
+        Deadline deadline(timeout / 1000, (timeout % 1000) * 1000000);
+        return _rwlock.beforeRead(&deadline);
+      }
+
+      virtual bool tryAcquire(const Deadline& deadline) {
+        return _rwlock.beforeRead(&deadline);
+      }
+
+      virtual void release() {
+        _rwlock.afterRead();
+      }
+
+    };
+
+    //! @class UpgradableLock
+    class UpgradableLock : public Lockable {
+
+      UpgradableReadWriteLock& _rwlock;
+
+    public:
+
+      UpgradableLock(UpgradableReadWriteLock& rwlock) : _rwlock(rwlock) {}
+
+      virtual ~UpgradableLock() {}
+
+      virtual void acquire() {
+        _rwlock.beforeUpgradable(0);
+      }
+
+      virtual bool tryAcquire(unsigned long timeout) {
+        Deadline deadline(timeout / 1000, (timeout % 1000) * 1000000);
+        return _rwlock.beforeUpgradable(&deadline);
+      }
+
+      virtual bool tryAcquire(const Deadline& deadline) {
+        return _rwlock.beforeUpgradable(&deadline);
+      }
+
+      virtual void release() {
+        _rwlock.afterUpgradable();
+      }
+
+    };
+
+    //! @class WriteLock
+    class WriteLock : public Lockable {
+
+      UpgradableReadWriteLock& _rwlock;
+
+    public:
+
+      WriteLock(UpgradableReadWriteLock& rwlock) : _rwlock(rwlock) {}
+
+      virtual ~WriteLock() {}
+
+      virtual void acquire() {
+        _rwlock.beforeWrite(0);
+      }
+
+      virtual bool tryAcquire(unsigned long timeout) {
+        Deadline deadline(timeout / 1000, (timeout % 1000) * 1000000);
+        return _rwlock.beforeWrite(&deadline);
+      }
+
+      virtual bool tryAcquire(const Deadline& deadline) {
+        return _rwlock.beforeWrite(&deadline);
+      }
+
+      virtual void release() {
+        _rwlock.afterWrite();
+      }
+
+    };
+
+    friend class ReadLock;
+    friend class UpgradableLock;
+    friend class WriteLock;
+
+    ReadLock _rlock;
+    UpgradableLock _ulock;
+    WriteLock _wlock;
+
+  public:
+  
+    /**
+     * Create an UpgradableReadWriteLock
+     *
+     * @exception Initialization_Exception thrown if resources could not be 
+     *            allocated for this object.
+     */
+    UpgradableReadWriteLock() 
+      : _condRead(_lock), _condWrite(_lock), _condUpgrade(_lock), 
+        _rlock(*this), _ulock(*this), _wlock(*this) {
+
+      _activeReaders = 0;
+      _activeWriter = false;
+      _activeUpgrader = false;
+      _upgrading = false;
+
+      _waitingWriters = 0;
+
+    }
+
+    //! Destroy this ReadWriteLock
+    virtual ~UpgradableReadWriteLock() {}
+
+    /**
+     * @see ReadWriteLock::getReadLock()
+     */
+    virtual Lockable& getReadLock() { return _rlock; }
+
+    /**
+     * @see ReadWriteLock::getWriteLock()
+     */
+    virtual Lockable& getWriteLock() { return _wlock; }
+
+    /**
+     * Get a reference to the upgradable Lockable. It provides read-only access that
+     * can be upgrade()d to read-write access.
+     *
+     * @return <em>Lockable&</em> reference to the upgradable Lockable.
+     */
+    Lockable& getUpgradableLock() { return _ulock; }
+
+    /**
+     * Exchange the upgradable lock for the write lock, waiting for the remaining 
+     * readers to leave. 
+     *
+     * @exception Interrupted_Exception thrown if the calling thread is interrupted
+     *            while waiting; it still holds the upgradable lock.
+     * @exception InvalidOp_Exception thrown if the upgradable lock is not held.
+     *
+     * @pre the calling thread holds the upgradable lock.
+     * @post the calling thread holds the write lock.
+     */
+    void upgrade() {
+      beforeUpgrade(0);
+    }
+
+    /**
+     * Attempt to exchange the upgradable lock for the write lock.
+     *
+     * @param timeout milliseconds to wait for the remaining readers to leave
+     *
+     * @return 
+     *   - <em>true</em> if the calling thread now holds the write lock.
+     *   - <em>false</em> if the readers did not leave in time; the calling thread
+     *     still holds the upgradable lock.
+     *
+     * @see upgrade()
+     */
+    bool tryUpgrade(unsigned long timeout) {
+      Deadline deadline(timeout / 1000, (timeout % 1000) * 1000000);
+      return beforeUpgrade(&deadline);
+    }
+
+    /**
+     * Attempt to exchange the upgradable lock for the write lock.
+     *
+     * @param deadline Deadline after which to stop waiting for the remaining readers
+     *
+     * @return 
+     *   - <em>true</em> if the calling thread now holds the write lock.
+     *   - <em>false</em> if the deadline passed first; the calling thread still 
+     *     holds the upgradable lock.
+     *
+     * @see upgrade()
+     */
+    bool tryUpgrade(const Deadline& deadline) {
+      return beforeUpgrade(&deadline);
+    }
+
+    /**
+     * Exchange the write lock for the upgradable lock. Readers are let in, and 
+     * the calling thread can upgrade() again later.
+     *
+     * @exception InvalidOp_Exception thrown if the write lock is not held.
+     *
+     * @pre the calling thread holds the write lock.
+     * @post the calling thread holds the upgradable lock.
+     */
+    void downgrade() {
+
+      Guard<FastMutex> g(_lock);
+
+      if(!_activeWriter)
+        throw InvalidOp_Exception();
+
+      _activeWriter = false;
+      _activeUpgrader = true;
+
+      wakeReaders();
+
+    }
+
+    /**
+     * Exchange the write lock for the read lock, letting other readers in.
+     *
+     * @exception InvalidOp_Exception thrown if the write lock is not held.
+     *
+     * @pre the calling thread holds the write lock.
+     * @post the calling thread holds the read lock.
+     */
+    void downgradeToRead() {
+
+      Guard<FastMutex> g(_lock);
+
+      if(!_activeWriter)
+        throw InvalidOp_Exception();
+
+      _activeWriter = false;
+      ++_activeReaders;
+
+      // Also admits a waiting upgrader
+      wakeReaders();
+
+    }
+  
+  protected:
+
+    bool beforeRead(const Deadline* deadline) {
+
+      Guard<FastMutex> g(_lock);
+
+      while(!allowReader())
+        if(!wait(_condRead, deadline))
+          return false;
+
+      ++_activeReaders;
+      return true;
+
+    }
+
+    void afterRead() {
+
+      Guard<FastMutex> g(_lock);
+
+      if(--_activeReaders > 0)
+        return;
+
+      if(_upgrading)
+        _condUpgrade.signal();
+
+      else if(_waitingWriters > 0 && !_activeUpgrader)
+        _condWrite.signal();
+
+    }
+
+    bool beforeUpgradable(const Deadline* deadline) {
+
+      Guard<FastMutex> g(_lock);
+
+      while(!allowUpgrader())
+        if(!wait(_condRead, deadline))
+          return false;
+
+      _activeUpgrader = true;
+      return true;
+
+    }
+
+    void afterUpgradable() {
+
+      Guard<FastMutex> g(_lock);
+      _activeUpgrader = false;
+
+      if(_waitingWriters > 0) {
+        
+        if(_activeReaders == 0)
+          _condWrite.signal();
+
+      } else
+        _condRead.broadcast();
+
+    }
+
+    bool beforeWrite(const Deadline* deadline) {
+
+      Guard<FastMutex> g(_lock);
+
+      ++_waitingWriters;
+
+      while(!allowWriter()) {
+
+        bool result = false;
+
+        try {
+
+          result = wait(_condWrite, deadline);
+
+        } catch(...) {
+
+          --_waitingWriters;
+          wakeReaders();
+
+          throw;
+
+        }
+
+        if(!result) {
+
+          --_waitingWriters;
+          wakeReaders();
+
+          return false;
+
+        }
+
+      }
+
+      --_waitingWriters;
+      _activeWriter = true;
+
+      return true;
+
+    }
+
+    void afterWrite() {
+
+      Guard<FastMutex> g(_lock);
+      _activeWriter = false;
+
+      if(_waitingWriters > 0)
+        _condWrite.signal();
+      else
+        _condRead.broadcast();
+
+    }
+
+    bool beforeUpgrade(const Deadline* deadline) {
+
+      Guard<FastMutex> g(_lock);
+
+      if(!_activeUpgrader)
+        throw InvalidOp_Exception();
+
+      _upgrading = true;
+
+      while(_activeReaders > 0) {
+
+        bool result = false;
+
+        try {
+
+          result = wait(_condUpgrade, deadline);
+
+        } catch(...) {
+
+          _upgrading = false;
+          wakeReaders();
+
+          throw;
+
+        }
+
+        if(!result) {
+
+          _upgrading = false;
+          wakeReaders();
+
+          return false;
+
+        }
+
+      }
+
+      _upgrading = false;
+      _activeUpgrader = false;
+      _activeWriter = true;
+
+      return true;
+
+    }
+
+    //! Let readers and upgraders recheck, unless a writer is next
+    void wakeReaders() {
+
+      if(_waitingWriters == 0)
+        _condRead.broadcast();
+      
+    }
+
+    bool wait(Condition& cond, const Deadline* deadline) {
+      
+      if(deadline == 0) {
+
+        cond.wait();
+        return true;
+
+      }
+
+      return cond.wait(*deadline);
+
+    }
+
+    bool allowReader() {
+      return !_activeWriter && !_upgrading && _waitingWriters == 0;
+    }
+
+    bool allowUpgrader() {
+      return !_activeWriter && !_activeUpgrader && _waitingWriters == 0;
+    }
+
+    bool allowWriter() {
+      return !_activeWriter && !_activeUpgrader && _activeReaders == 0;
+    }
+
+  };
+
+
+  /**
+   * @class UpgradedScope
+   * @version 2.3.3
+   *
+   * Locking policy for an UpgradableReadWriteLock whose upgradable lock is already
+   * held. This policy upgrade()s to the write lock when the protection scope is 
+   * created, and downgrade()s back to the upgradable lock when the scope is destroyed.
+   *
+   * @code
+   *
+   * Guard<UpgradableReadWriteLock, UpgradedScope> g(rwlock);
+   *
+   * @endcode
+   */
+  class UpgradedScope {
+  public:
+
+    template <class LockType>
+    static void createScope(LockHolder<LockType>& l) {
+
+      l.getLock().upgrade();
+
+    }
+
+    template <class LockType>
+    static bool createScope(LockHolder<LockType>& l, unsigned long ms) {
+
+      return l.getLock().tryUpgrade(ms);
+
+    }
+
+    template <class LockType>
+    static bool createScope(LockHolder<LockType>& l, const Deadline& deadline) {
+
+      return l.getLock().tryUpgrade(deadline);
+
+    }
+
+    template <class LockType>
+    static void destroyScope(LockHolder<LockType>& l) {
+
+      l.getLock().downgrade();
+
+    }
+
+  };
+
+
+  /**
+   * @class DowngradedScope
+   * @version 2.3.3
+   *
+   * Locking policy for an UpgradableReadWriteLock whose write lock is already
+   * held. This policy downgrade()s to the upgradable lock when the protection scope 
+   * is created, letting readers in, and upgrade()s back to the write lock when the
+   * scope is destroyed.
+   *
+   * @code
+   *
+   * Guard<UpgradableReadWriteLock, DowngradedScope> g(rwlock);
+   *
+   * @endcode
+   */
+  class DowngradedScope {
+  public:
+
+    template <class LockType>
+    static void createScope(LockHolder<LockType>& l) {
+
+      l.getLock().downgrade();
+
+    }
+
+    template <class LockType>
+    static void destroyScope(LockHolder<LockType>& l) {
+
+      l.getLock().upgrade();
+
+    }
+
+  };
+
+} // namespace ZThread
+
+#endif // __ZTUPGRADABLEREADWRITELOCK_H__
@@ -23,6 +23,7 @@
 #ifndef __ZTWAITABLE_H__
 #define __ZTWAITABLE_H__
 
+#include "zthread/Deadline.h"
 #include "zthread/Exceptions.h"
 
 namespace ZThread { 
@@ -85,6 +86,29 @@ namespace ZThread {
      */
     virtual bool wait(unsigned long timeout) = 0;
 
+    /**
+     * Waiting on an object will generally cause the calling thread to be blocked
+     * for some indefinite period of time, but no later than the given Deadline.
+     *
+     * Specializations that can block with a finer resolution override this method;
+     * by default the time left before the Deadline is rounded up to the next 
+     * millisecond and passed to wait(unsigned long). At least one millisecond is 
+     * passed, since not every Waitable treats a timeout of 0 as an expired one.
+     *
+     * @param deadline time after which the calling thread stops waiting.
+     *
+     * @return 
+     *   - <em>true</em> if the set of tasks being wait for complete before 
+     *                   the deadline passes.
+     *   - <em>false</em> othewise.
+     */
+    virtual bool wait(const Deadline& deadline) {
+
+      unsigned long ms = deadline.milliseconds();
+      return wait(ms == 0 ? 1 : ms);
+
+    }
+
   
   }; /* Waitable */
 
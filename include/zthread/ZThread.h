@@ -28,18 +28,23 @@
 #include "zthread/BiasedReadWriteLock.h"
 #include "zthread/BlockingQueue.h"
 #include "zthread/BoundedQueue.h"
+#include "zthread/Callable.h"
 #include "zthread/Cancelable.h"
 #include "zthread/ClassLockable.h"
 #include "zthread/ConcurrentExecutor.h"
 #include "zthread/Condition.h"
+#include "zthread/Continuation.h"
 #include "zthread/Config.h"
 #include "zthread/CountedPtr.h"
 #include "zthread/CountingSemaphore.h"
+#include "zthread/Deadline.h"
 #include "zthread/Exceptions.h"
 #include "zthread/Executor.h"
 #include "zthread/FairReadWriteLock.h"
 #include "zthread/FastMutex.h"
 #include "zthread/FastRecursiveMutex.h"
+#include "zthread/Future.h"
+#include "zthread/FutureTask.h"
 #include "zthread/Guard.h"
 #include "zthread/Lockable.h"
 #include "zthread/LockedQueue.h"
@@ -55,13 +60,17 @@
 #include "zthread/Queue.h"
 #include "zthread/ReadWriteLock.h"
 #include "zthread/RecursiveMutex.h"
+#include "zthread/RingQueue.h"
 #include "zthread/Runnable.h"
 #include "zthread/Semaphore.h"
+#include "zthread/SeqLock.h"
 #include "zthread/Singleton.h"
+#include "zthread/StripedReadWriteLock.h"
 #include "zthread/SynchronousExecutor.h"
 #include "zthread/Thread.h"
 #include "zthread/ThreadLocal.h"
 #include "zthread/Time.h"
+#include "zthread/UpgradableReadWriteLock.h"
 #include "zthread/Waitable.h"
 
 #endif
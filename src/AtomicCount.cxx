@@ -52,6 +52,9 @@
 #endif
 */
 
+// The inline AtomicCount needs no implementation here
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
 #  include "vanilla/SimpleAtomicCount.cxx"
+#endif
 
 #endif // __ZTATOMICCOUNTSELECT_H__
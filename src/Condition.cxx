@@ -61,6 +61,12 @@ namespace ZThread {
 
   }
 
+  bool Condition::wait(const Deadline& deadline) {
+
+    return _impl->wait(deadline);
+
+  }
+
 
 
   void Condition::signal() {
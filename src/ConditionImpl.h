@@ -26,7 +26,9 @@
 #include "zthread/Guard.h"
 
 #include "Debug.h"
+#include "MutexImpl.h"
 #include "Scheduling.h"
+#include "Timeout.h"
 #include "DeferredInterruptionScope.h"
 
 namespace ZThread {
@@ -39,6 +41,19 @@ namespace ZThread {
  *
  * The ConditionImpl template allows how waiter lists are sorted
  * to be parameteized
+ *
+ * A waiter always lets go of its Monitor before it competes for the lock 
+ * of the ConditionImpl again, so signal() and broadcast() can lock the 
+ * Monitor of each waiter they pick without ever backing off. Whether the 
+ * waiter still accepts the signal is decided under that Monitor; a waiter 
+ * whose wait ended just before it was picked takes the signal it was 
+ * handed, instead of leaving it pending on its Monitor.
+ *
+ * When the external lock is a Mutex or PriorityMutex that is owned at the 
+ * time, the waiters that are picked are moved onto the waiter list of that 
+ * mutex instead of being woken (wait morphing). Each one wakes only once 
+ * the mutex is handed to it, rather than all of them waking at once to 
+ * contend for it.
  */ 
 template <typename List> 
 class ConditionImpl {
@@ -52,6 +67,12 @@ class ConditionImpl {
   //! External lock
   Lockable& _predicateLock;
 
+  //! External lock that waiters can be moved onto, if any
+  RequeueTarget* _requeue;
+
+  //! Set once _requeue has been looked up
+  bool _resolved;
+
  public:
 
   /**
@@ -60,7 +81,8 @@ class ConditionImpl {
    * @exception Initialization_Exception thrown if resources could not be
    * allocated
    */
-  ConditionImpl(Lockable& predicateLock) : _predicateLock(predicateLock) {
+  ConditionImpl(Lockable& predicateLock) 
+    : _predicateLock(predicateLock), _requeue(0), _resolved(false) {
 
   }
 
@@ -75,7 +97,16 @@ class ConditionImpl {
 
   void wait();
 
-  bool wait(unsigned long timeout);
+  template <class Timeout>
+  bool wait(const Timeout& timeout);
+
+ private:
+
+  void resolve();
+
+  bool handoff(ThreadImpl* impl);
+
+  bool requeued(ThreadImpl* self, Monitor& m, Monitor::STATE& state);
 
 };
 
@@ -106,45 +137,17 @@ void ConditionImpl<List>::signal() {
 
     Guard<FastLock> g1(_lock);
 
-    // Try to find a waiter with a backoff & retry scheme
-    for(;;) {
-    
-      // Go through the list, attempt to notify() a waiter.
-      for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
-
-        // Try the monitor lock, if it cant be locked skip to the next waiter
-        ThreadImpl* impl = *i;
-        Monitor& m = impl->getMonitor();
-
-        if(m.tryAcquire()) {
-        
-          // Notify the monitor & remove from the waiter list so time isn't
-          // wasted checking it again.
-          i = _waiters.erase(i);
-        
-          // If notify() is not sucessful, it is because the wait() has already 
-          // been ended (killed/interrupted/notify'd)
-          bool woke = m.notify();
-        
-          m.release();
-        
-          // Once notify() succeeds, return
-          if(woke) 
-            return;
-        
-        } else ++i;
-      
-      }
-    
-      if(_waiters.empty())
-        return;
-    
-      { // Backoff and try again
+    resolve();
 
-        Guard<FastLock, UnlockedScope> g2(g1);
-        ThreadImpl::yield();
+    // Hand the signal to the first waiter that accepts it. Waiters that 
+    // decline it are ending their wait anyway (killed/interrupted/timed out)
+    for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
 
-      }
+      ThreadImpl* impl = *i;
+      i = _waiters.erase(i);
+
+      if(handoff(impl))
+        return;
 
     }
 
@@ -159,46 +162,109 @@ void ConditionImpl<List>::broadcast() {
 
     Guard<FastLock> g1(_lock);
 
-    // Try to find a waiter with a backoff & retry scheme
-    for(;;) {
-    
-      // Go through the list, attempt to notify() a waiter.
-      for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
-
-        // Try the monitor lock, if it cant be locked skip to the next waiter
-        ThreadImpl* impl = *i;
-        Monitor& m = impl->getMonitor();
-
-        if(m.tryAcquire()) {
-        
-          // Notify the monitor & remove from the waiter list so time isn't
-          // wasted checking it again.
-          i = _waiters.erase(i);
-        
-          // Try to wake the waiter, it doesn't matter if this is successful
-          // or not (only fails when the monitor is already going to stop waiting). 
-          m.notify();
-        
-          m.release();
-        
-        } else ++i;
-      
-      }
-    
-      if(_waiters.empty())
-        return;
+    resolve();
 
-      { // Backoff and try again
+    for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
 
-        Guard<FastLock, UnlockedScope> g2(g1);
-        ThreadImpl::yield();
+      ThreadImpl* impl = *i;
+      i = _waiters.erase(i);
 
-      }
+      handoff(impl);
+
+    }
+
+  }
+
+/**
+ * Find out whether waiters can be moved onto the external lock. This is put off 
+ * until the first signal, since the external lock need not have been constructed 
+ * yet when this object is.
+ *
+ * @pre the lock for this ConditionImpl is held
+ */
+template <typename List> 
+void ConditionImpl<List>::resolve() {
+
+    if(!_resolved) {
+
+      _requeue = RequeueTarget::find(_predicateLock);
+      _resolved = true;
 
     }
 
   }
 
+/**
+ * Wake a waiter that has been taken off the waiter list, or move it onto the 
+ * external lock if that lock is owned.
+ *
+ * @param impl waiter
+ * @return bool false if the wait had already ended, or the waiter was interrupted
+ *
+ * @pre the lock for this ConditionImpl is held
+ */
+template <typename List> 
+bool ConditionImpl<List>::handoff(ThreadImpl* impl) {
+
+    Monitor& m = impl->getMonitor();
+    Guard<Monitor> g(m);
+
+    if(!impl->_signalable)
+      return false;
+
+    // A requeued waiter stays signalable, until the external lock is handed 
+    // to it
+    if(_requeue && _requeue->requeue(impl)) {
+
+      impl->_requeued = true;
+      return true;
+
+    }
+
+    // notify() fails only when the waiter is interrupted
+    if(!m.notify())
+      return false;
+
+    impl->_signalable = false;
+    return true;
+
+  }
+
+/**
+ * Finish the wait of a thread that was moved onto the external lock. Having 
+ * been picked by signal() or broadcast(), the wait reports SIGNALED even if 
+ * it ended for some other reason; an interruption is kept pending for the 
+ * next interruptable operation. The external lock is told once the Monitor
+ * has been let go, see RequeueTarget::departed().
+ *
+ * @param self calling thread
+ * @param m Monitor of the calling thread
+ * @param state STATE that ended the wait, updated to SIGNALED
+ * @return bool true if the external lock was handed to the calling thread,
+ *         false if it still has to be acquired
+ *
+ * @pre the Monitor is held
+ */
+template <typename List> 
+bool ConditionImpl<List>::requeued(ThreadImpl* self, Monitor& m, Monitor::STATE& state) {
+
+    self->_requeued = false;
+
+    if(!self->_signalable) {
+
+      state = acceptHandoff(m, state);
+      return true;
+
+    }
+
+    if(state == Monitor::INTERRUPTED)
+      m.interrupt();
+
+    state = Monitor::SIGNALED;
+    return false;
+
+  }
+
 /** 
  * Cause the currently executing thread to block until this ConditionImpl has
  * been signaled, the threads state changes.
@@ -217,6 +283,9 @@ void ConditionImpl<List>::wait() {
 
     Monitor::STATE state;
 
+    // Set if the external lock was handed over by a requeue
+    bool locked = false;
+
     {
 
       Guard<FastLock> g1(_lock);
@@ -229,30 +298,42 @@ void ConditionImpl<List>::wait() {
     
       // Move to the monitor's lock
       m.acquire();
+      self->_signalable = true;
 
       {
 
         Guard<FastLock, UnlockedScope> g2(g1);
         state = m.wait();
+
+        // Take a signal, or the external lock, handed over after the wait ended
+        bool moved = self->_requeued;
+        if(moved)
+          locked = requeued(self, m, state);
+        else if(!self->_signalable)
+          state = acceptHandoff(m, state);
+
+        self->_signalable = false;
+
+        // Let go of the monitor before moving back to the Condition's lock
+        m.release();
+
+        // Leave the external lock's waiters without the monitor held
+        if(moved)
+          _requeue->departed(self, locked);
     
       }
 
-      // Move back to the Condition's lock
-      m.release();
-    
-      // Remove from waiter list, regarless of weather release() is called or
+      // Remove from waiter list, regarless of weather signal() is called or
       // not. The monitor is sticky, so its possible a state 'stuck' from a
-      // previous operation and will leave the wait() w/o release() having
+      // previous operation and will leave the wait() w/o signal() having
       // been called.
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
+      _waiters.remove(self);
     
     }
 
     // Defer interruption until the external lock is acquire()d
     Guard<Monitor, DeferredInterruptionScope> g3(m);
-    {
+    if(!locked) {
 
 #if !defined(NDEBUG)
       try {
@@ -284,7 +365,7 @@ void ConditionImpl<List>::wait() {
  * been signaled, or the timeout expires or the threads state changes.
  *
  * @param _predicateLock Lockable& 
- * @param timeout maximum milliseconds to block.
+ * @param timeout maximum milliseconds to block, or a Deadline.
  *
  * @return bool
  *
@@ -292,7 +373,8 @@ void ConditionImpl<List>::wait() {
  * @exception Synchronization_Exception thrown if there is some other error.
  */
 template <typename List> 
-bool ConditionImpl<List>::wait(unsigned long timeout) {
+template <class Timeout>
+bool ConditionImpl<List>::wait(const Timeout& timeout) {
   
     // Get the monitor for the current thread
     ThreadImpl* self = ThreadImpl::current();
@@ -300,6 +382,9 @@ bool ConditionImpl<List>::wait(unsigned long timeout) {
 
     Monitor::STATE state;
 
+    // Set if the external lock was handed over by a requeue
+    bool locked = false;
+
     {
 
       Guard<FastLock> g1(_lock);
@@ -312,36 +397,49 @@ bool ConditionImpl<List>::wait(unsigned long timeout) {
     
       state = Monitor::TIMEDOUT;
     
-      // Don't bother waiting if the timeout is 0
-      if(timeout) {
+      // Don't bother waiting if the timeout has already expired
+      if(!expired(timeout)) {
     
         m.acquire();
+        self->_signalable = true;
 
         {
 
           Guard<FastLock, UnlockedScope> g2(g1);
           state = m.wait(timeout);
 
-        }
+          // Take a signal, or the external lock, handed over after the wait ended
+          bool moved = self->_requeued;
+          if(moved)
+            locked = requeued(self, m, state);
+          else if(!self->_signalable)
+            state = acceptHandoff(m, state);
 
-        m.release();
+          self->_signalable = false;
+
+          // Let go of the monitor before moving back to the Condition's lock
+          m.release();
+
+          // Leave the external lock's waiters without the monitor held
+          if(moved)
+            _requeue->departed(self, locked);
+
+        }
       
       }
     
-      // Remove from waiter list, regarless of weather release() is called or
+      // Remove from waiter list, regarless of weather signal() is called or
       // not. The monitor is sticky, so its possible a state 'stuck' from a
-      // previous operation and will leave the wait() w/o release() having
+      // previous operation and will leave the wait() w/o signal() having
       // been called.
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
+      _waiters.remove(self);
     
     }
 
 
     // Defer interruption until the external lock is acquire()d
     Guard<Monitor, DeferredInterruptionScope> g3(m);
-    {
+    if(!locked) {
 
 #if !defined(NDEBUG)
       try {
@@ -83,6 +83,12 @@ namespace ZThread {
 
   }
 
+  bool CountingSemaphore::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline);
+
+  }
+
   void CountingSemaphore::release() {
 
     _impl->release();
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "zthread/Deadline.h"
+#include "TimeStrategy.h"
+
+using namespace ZThread;
+
+namespace {
+
+  const unsigned long NANOS_PER_SECOND = 1000000000UL;
+
+}
+
+Deadline::Deadline() {
+
+  TimeStrategy now;
+
+  _seconds = now.seconds();
+  _nanoseconds = now.nanoseconds();
+
+}
+
+Deadline::Deadline(unsigned long secs, unsigned long nanos) {
+
+  TimeStrategy now;
+
+  nanos += now.nanoseconds();
+
+  _seconds = now.seconds() + secs + (nanos / NANOS_PER_SECOND);
+  _nanoseconds = nanos % NANOS_PER_SECOND;
+
+}
+
+bool Deadline::expired() const {
+
+  TimeStrategy now;
+
+  return now.seconds() > _seconds || 
+    (now.seconds() == _seconds && now.nanoseconds() >= _nanoseconds);
+
+}
+
+bool Deadline::remaining(unsigned long& secs, unsigned long& nanos) const {
+
+  TimeStrategy now;
+
+  secs = 0;
+  nanos = 0;
+
+  if(now.seconds() > _seconds || 
+     (now.seconds() == _seconds && now.nanoseconds() >= _nanoseconds))
+    return false;
+
+  secs = _seconds - now.seconds();
+
+  if(_nanoseconds >= now.nanoseconds())
+    nanos = _nanoseconds - now.nanoseconds();
+
+  else {
+
+    secs -= 1;
+    nanos = _nanoseconds + NANOS_PER_SECOND - now.nanoseconds();
+
+  }
+
+  return true;
+
+}
+
+unsigned long Deadline::milliseconds() const {
+
+  unsigned long secs, nanos;
+  if(!remaining(secs, nanos))
+    return 0;
+
+  return secs * 1000 + (nanos + 999999) / 1000000;
+
+}
@@ -42,6 +42,11 @@
 
 #  endif
 
+// Park threads directly on the lock word when possible
+#  if defined(__linux__) && !defined(ZTHREAD_DISABLE_FUTEX)
+#    include "linux/FutexFastLock.h"
+#  endif
+
 #  include "posix/FastLock.h"
 
 // Use spin locks
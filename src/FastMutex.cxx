@@ -44,6 +44,12 @@ namespace ZThread {
 
   }
 
+  bool FastMutex::tryAcquire(const Deadline&) {
+  
+    return _lock->tryAcquire();
+
+  }
+
   void FastMutex::release() {
 
     _lock->release();
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "zthread/Future.h"
+#include "zthread/Executor.h"
+#include "zthread/Guard.h"
+
+#include "FastLock.h"
+#include "MutexImpl.h"
+#include "Scheduling.h"
+#include "ThreadImpl.h"
+
+#include <assert.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ZThread {
+
+  /**
+   * @class FutureImpl
+   * @version 2.3.3
+   *
+   * Outcome of a Future, and the threads waiting for it. Waiters follow the
+   * same protocol as the waiters of a ConditionImpl: each blocks on its own
+   * Monitor, and lets go of it before it competes for the lock of the 
+   * FutureImpl again, so that a completing thread can lock the Monitor of 
+   * every waiter without backing off.
+   *
+   * CompletionTasks are kept until the outcome is final, and are then handed to 
+   * their Executors, or run, after the lock of the FutureImpl has been released.
+   */
+  class FutureImpl {
+  public:
+
+    //! Outcomes at or after READY are final
+    typedef enum { PENDING, CLAIMED, READY, FAILED, CANCELED } STATE;
+
+    typedef CountedPtr<CompletionTask, AtomicCount> TaskPtr;
+
+    //! CompletionTasks and their Executors, 0 to run a task in place
+    typedef std::vector< std::pair<Executor*, TaskPtr> > TaskList;
+
+  private:
+
+    //! Serialize access to this object
+    FastLock _lock;
+
+    //! Threads waiting for an outcome
+    fifo_list _waiters;
+
+    //! Tasks to schedule once the outcome is final
+    TaskList _tasks;
+
+    STATE _state;
+
+    //! Reason a FAILED result failed
+    std::string _reason;
+
+    //! Promises that can still publish the outcome
+    size_t _promises;
+
+  public:
+
+    FutureImpl() : _state(PENDING), _promises(0) { }
+
+    ~FutureImpl() {
+      assert(_waiters.empty());
+    }
+
+    STATE state() {
+
+      Guard<FastLock> g(_lock);
+      return _state;
+
+    }
+
+    const std::string& reason() const {
+      return _reason;
+    }
+
+    //! Count another Promise
+    void promised() {
+
+      Guard<FastLock> g(_lock);
+      ++_promises;
+
+    }
+
+    //! Forget a Promise, true if it was the last one
+    bool unpromised() {
+
+      Guard<FastLock> g(_lock);
+      return --_promises == 0;
+
+    }
+
+    //! Move from one state to another, false if the current state is different
+    bool transition(STATE from, STATE to, const char* reason = 0) {
+
+      TaskList tasks;
+
+      {
+
+        Guard<FastLock> g(_lock);
+
+        if(_state != from)
+          return false;
+
+        _state = to;
+
+        if(reason)
+          _reason = reason;
+
+        if(to >= READY) {
+
+          wakeAll();
+          tasks.swap(_tasks);
+
+        }
+
+      }
+
+      dispatch(tasks);
+      return true;
+
+    }
+
+    //! Schedule a task once the outcome is final, at once if it already is
+    void whenDone(Executor* executor, const TaskPtr& task) {
+
+      TaskList tasks;
+
+      {
+
+        Guard<FastLock> g(_lock);
+
+        if(_state < READY) {
+
+          _tasks.push_back(std::make_pair(executor, task));
+          return;
+
+        }
+
+      }
+
+      tasks.push_back(std::make_pair(executor, task));
+      dispatch(tasks);
+
+    }
+
+    bool wait(const Deadline* deadline);
+
+  private:
+
+    void wakeAll();
+
+    void dispatch(TaskList& tasks);
+
+  };
+
+  /**
+   * Block until the outcome is final, or the deadline passes.
+   *
+   * @param deadline Deadline, or 0 to wait forever
+   * @return bool true if the outcome is final
+   *
+   * @exception Interrupted_Exception thrown when the caller status is interrupted
+   * @exception Synchronization_Exception thrown if there is some other error.
+   */
+  bool FutureImpl::wait(const Deadline* deadline) {
+
+    ThreadImpl* self = ThreadImpl::current();
+    Monitor& m = self->getMonitor();
+
+    Guard<FastLock> g1(_lock);
+
+    // A wakeup can be left over from an earlier wait on the same Monitor, 
+    // so keep waiting until the outcome is actually final
+    while(_state < READY) {
+
+      // Don't bother waiting if the deadline has already passed
+      if(deadline && deadline->expired())
+        return false;
+
+      Monitor::STATE state;
+
+      _waiters.insert(self);
+
+      m.acquire();
+      self->_signalable = true;
+
+      {
+
+        Guard<FastLock, UnlockedScope> g2(g1);
+        state = deadline ? m.wait(*deadline) : m.wait();
+
+        // Take a wakeup handed over after the wait ended
+        if(!self->_signalable)
+          state = acceptHandoff(m, state);
+
+        self->_signalable = false;
+
+        // Let go of the monitor before moving back to the lock of the FutureImpl
+        m.release();
+
+      }
+
+      _waiters.remove(self);
+
+      switch(state) {
+
+        case Monitor::SIGNALED:
+          break;
+
+        case Monitor::TIMEDOUT:
+          return _state >= READY;
+
+        case Monitor::INTERRUPTED:
+          throw Interrupted_Exception();
+
+        default:
+          throw Synchronization_Exception();
+
+      }
+
+    }
+
+    return true;
+
+  }
+
+  /**
+   * Wake every waiter
+   *
+   * @pre the lock for this FutureImpl is held
+   */
+  void FutureImpl::wakeAll() {
+
+    for(fifo_list::iterator i = _waiters.begin(); i != _waiters.end();) {
+
+      ThreadImpl* impl = *i;
+      i = _waiters.erase(i);
+
+      Monitor& m = impl->getMonitor();
+      Guard<Monitor> g(m);
+
+      // notify() fails only when the waiter is interrupted
+      if(impl->_signalable && m.notify())
+        impl->_signalable = false;
+
+    }
+
+  }
+
+  /**
+   * Hand each task to its Executor, or run it in place. A task that an Executor 
+   * refuses is told so instead.
+   *
+   * @pre the lock for this FutureImpl is not held
+   */
+  void FutureImpl::dispatch(TaskList& tasks) {
+
+    for(TaskList::iterator i = tasks.begin(); i != tasks.end(); ++i) {
+
+      TaskPtr& task = i->second;
+
+      try {
+
+        if(!i->first)
+          task->run();
+
+        else try {
+
+          i->first->execute(task);
+
+        } catch(Cancellation_Exception&) {
+          task->refused();
+        }
+
+      } catch(...) { /* ignore */ }
+
+    }
+
+  }
+
+  FutureBase::FutureBase() {
+
+    _impl = new FutureImpl();
+
+  }
+
+  FutureBase::~FutureBase() {
+
+    delete _impl;
+
+  }
+
+  void FutureBase::wait() {
+
+    _impl->wait(0);
+
+  }
+
+  bool FutureBase::wait(unsigned long timeout) {
+
+    Deadline deadline(timeout / 1000, (timeout % 1000) * 1000000);
+    return _impl->wait(&deadline);
+
+  }
+
+  bool FutureBase::wait(const Deadline& deadline) {
+
+    return _impl->wait(&deadline);
+
+  }
+
+  bool FutureBase::cancel() {
+
+    return _impl->transition(FutureImpl::PENDING, FutureImpl::CANCELED);
+
+  }
+
+  bool FutureBase::isCanceled() {
+
+    return _impl->state() == FutureImpl::CANCELED;
+
+  }
+
+  bool FutureBase::isDone() {
+
+    return _impl->state() >= FutureImpl::READY;
+
+  }
+
+  bool FutureBase::fail(const char* reason) {
+
+    return _impl->transition(FutureImpl::PENDING, FutureImpl::FAILED, reason);
+
+  }
+
+  void FutureBase::addPromise() {
+
+    _impl->promised();
+
+  }
+
+  void FutureBase::removePromise() {
+
+    if(_impl->unpromised())
+      fail("Promise was destroyed");
+
+  }
+
+  bool FutureBase::claim() {
+
+    return _impl->transition(FutureImpl::PENDING, FutureImpl::CLAIMED);
+
+  }
+
+  void FutureBase::publish() {
+
+    _impl->transition(FutureImpl::CLAIMED, FutureImpl::READY);
+
+  }
+
+  void FutureBase::abandon(const char* reason) {
+
+    _impl->transition(FutureImpl::CLAIMED, FutureImpl::FAILED, reason);
+
+  }
+
+  void FutureBase::whenDone(Executor& executor, const CountedPtr<CompletionTask, AtomicCount>& task) {
+
+    _impl->whenDone(&executor, task);
+
+  }
+
+  void FutureBase::whenDone(const CountedPtr<CompletionTask, AtomicCount>& task) {
+
+    _impl->whenDone(0, task);
+
+  }
+
+  void FutureBase::check() {
+
+    switch(_impl->state()) {
+
+      case FutureImpl::READY:
+        break;
+
+      case FutureImpl::CANCELED:
+        throw Cancellation_Exception();
+
+      case FutureImpl::FAILED:
+        throw Future_Exception(_impl->reason().c_str());
+
+      default:
+        throw InvalidOp_Exception();
+
+    }
+
+  }
+
+} // namespace ZThread
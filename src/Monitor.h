@@ -38,8 +38,18 @@
 // what the compilation environment has defined
 #if defined(ZT_POSIX)
 
-#  include "posix/Monitor.h"
-#  define ZT_MONITOR_IMPLEMENTATION "posix/Monitor.cxx"
+// Block directly on the status word when possible
+#  if defined(__linux__) && !defined(ZTHREAD_DISABLE_FUTEX)
+
+#    include "linux/Monitor.h"
+#    define ZT_MONITOR_IMPLEMENTATION "linux/Monitor.cxx"
+
+#  else
+
+#    include "posix/Monitor.h"
+#    define ZT_MONITOR_IMPLEMENTATION "posix/Monitor.cxx"
+
+#  endif
 
 #elif defined(ZT_WIN32) || defined(ZT_WIN9X)
 
@@ -21,12 +21,24 @@
  */
 
 #include "zthread/Mutex.h"
+#include "zthread/PriorityMutex.h"
 #include "MutexImpl.h"
 
 namespace ZThread {
 
-  class FifoMutexImpl : public MutexImpl<fifo_list, NullBehavior> { };
+  class FifoMutexImpl : public MutexImpl<fifo_list, SpinningBehavior> { };
 
+  RequeueTarget* RequeueTarget::find(Lockable& lock) {
+
+    if(Mutex* m = dynamic_cast<Mutex*>(&lock))
+      return m->_impl;
+
+    if(PriorityMutex* m = dynamic_cast<PriorityMutex*>(&lock))
+      return find(*m);
+
+    return 0;
+
+  }
 
   Mutex::Mutex() {
 
@@ -55,6 +67,12 @@ namespace ZThread {
 
   }
 
+  bool Mutex::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline);
+
+  }
+
   // V
   void Mutex::release() {
 
@@ -26,12 +26,14 @@
 #include "Debug.h"
 #include "FastLock.h"
 #include "Scheduling.h"
+#include "Timeout.h"
 
 #include <assert.h>
 #include <errno.h>
 
 namespace ZThread {
 
+class PriorityMutex;
 
 /**
  * @author Eric Crahen <http://www.code-foo.com>
@@ -50,8 +52,130 @@ protected:
 
   inline void ownerReleased(ThreadImpl*) {  }
 
+  //! Never spin, park a contending thread right away
+  inline int spinLimit() { return 0; }
+
+  inline void spinCompleted(int, bool) {  }
+
+};
+
+/**
+ * @version 2.3.3
+ * @class AdaptiveSpinBehavior
+ *
+ * Adds a short spin to another Behavior. A thread that finds the mutex 
+ * owned, with no other threads waiting, spins for a bounded time before 
+ * it parks, which saves a pair of context switches when the owner holds 
+ * the mutex only briefly. The length of the spin follows a running 
+ * estimate of how long recent spins took to succeed, in the style of 
+ * glibc's PTHREAD_MUTEX_ADAPTIVE_NP mutexes.
+ */
+template <typename Base = NullBehavior>
+class AdaptiveSpinBehavior : public Base {
+
+  //! Upper bound on the adaptive spin
+  enum { MAX_SPINS = 100 };
+
+  //! Running estimate of the spins needed to acquire the mutex
+  int _spins;
+
+protected:
+
+  AdaptiveSpinBehavior() : _spins(0) { }
+
+  inline int spinLimit() { 
+
+    int limit = _spins * 2 + 10;
+    return limit > MAX_SPINS ? MAX_SPINS : limit;
+
+  }
+
+  inline void spinCompleted(int n, bool acquired) {  
+    _spins += ((acquired ? n : spinLimit()) - _spins) / 8;
+  }
+
 };
 
+/**
+ * Take the mutex a releasing thread handed to a waiter after the wait of that 
+ * waiter had already ended for some other reason. The SIGNALED state is still 
+ * pending on the Monitor, and is consumed so that it can't end some later 
+ * wait() spuriously. An interruption that ended the wait is kept pending for 
+ * the next interruptable operation.
+ *
+ * @param m Monitor of the calling thread
+ * @param state STATE that ended the wait
+ * @return SIGNALED
+ *
+ * @pre the Monitor is held
+ */
+inline Monitor::STATE acceptHandoff(Monitor& m, Monitor::STATE state) {
+
+  if(state == Monitor::SIGNALED)
+    return state;
+
+  Monitor::STATE signaled = m.wait(); // Returns at once
+  assert(signaled == Monitor::SIGNALED);
+
+  if(state == Monitor::INTERRUPTED)
+    m.interrupt();
+
+  return signaled;
+
+}
+
+/**
+ * @class RequeueTarget
+ * @version 2.3.3
+ *
+ * A lock that a ConditionImpl can move its waiters onto. Instead of being 
+ * woken by signal() or broadcast() only to block on the lock again, a waiter 
+ * that has been requeued sleeps until the lock is handed to it.
+ */
+class RequeueTarget {
+public:
+
+  virtual ~RequeueTarget() { }
+
+  /**
+   * Add a thread blocked on a ConditionImpl to the waiters for this lock.
+   *
+   * @param impl waiter
+   * @return bool false if the lock is free, the waiter should be woken instead
+   *
+   * @pre the Monitor of the waiter is held
+   */
+  virtual bool requeue(ThreadImpl* impl) = 0;
+
+  /**
+   * Finish the wait of a requeued thread, once it has let go of its Monitor.
+   *
+   * @param self calling thread
+   * @param handed true if the lock was handed to the calling thread, false if
+   *        the calling thread is to be taken back off the waiter list
+   */
+  virtual void departed(ThreadImpl* self, bool handed) = 0;
+
+  /**
+   * Find the RequeueTarget behind a Lockable.
+   *
+   * @return RequeueTarget* for a Mutex or a PriorityMutex, otherwise 0
+   */
+  static RequeueTarget* find(Lockable& lock);
+
+private:
+
+  static RequeueTarget* find(PriorityMutex& lock);
+
+};
+
+//! Behavior of the mutexes that opt into spinning
+#if defined(ZTHREAD_DISABLE_ADAPTIVE_SPIN)
+typedef NullBehavior SpinningBehavior;
+#else
+typedef AdaptiveSpinBehavior<NullBehavior> SpinningBehavior;
+#endif
+
 /**
  * @author Eric Crahen <http://www.code-foo.com>
  * @date <2003-07-16T19:52:12-0400>
@@ -61,9 +185,14 @@ protected:
  * The MutexImpl template allows how waiter lists are sorted, and 
  * what actions are taken when a thread interacts with the mutex
  * to be parametized.
+ *
+ * release() hands the mutex directly to the waiter it wakes, taking it off 
+ * the waiter list, so no other thread can take the mutex first. A waiter 
+ * only holds its Monitor while it is not holding the lock for the mutex, so 
+ * release() can block on that Monitor to pick the waiter.
  */
 template <typename List, typename Behavior> 
-class MutexImpl : Behavior {
+class MutexImpl : Behavior, public RequeueTarget {
 
   //! List of Events that are waiting for notification 
   List _waiters;
@@ -72,7 +201,7 @@ class MutexImpl : Behavior {
   FastLock _lock;
 
   //! Current owner
-  volatile ThreadImpl* _owner;
+  ThreadImpl* volatile _owner;
 
  public:
   
@@ -91,7 +220,16 @@ class MutexImpl : Behavior {
   
   void release();
 
-  bool tryAcquire(unsigned long timeout);
+  template <class Timeout>
+  bool tryAcquire(const Timeout& timeout);
+
+  virtual bool requeue(ThreadImpl* impl);
+
+  virtual void departed(ThreadImpl* self, bool handed);
+
+ private:
+
+  void spin(Guard<FastLock>& g1);
 
 };
 
@@ -148,6 +286,10 @@ void MutexImpl<List, Behavior>::acquire() {
     if(_owner == self) 
       throw Deadlock_Exception();
     
+    // Give a briefly held lock a chance to be released before parking
+    if(_owner != 0 && _waiters.empty())
+      spin(g1);
+
     // Acquire the lock if it is free and there are no waiting threads
     if(_owner == 0 && _waiters.empty()) {
 
@@ -157,40 +299,50 @@ void MutexImpl<List, Behavior>::acquire() {
       
     }
 
-    // Otherwise, wait for a signal from a thread releasing its
-    // ownership of the lock
+    // Otherwise, wait for a thread releasing its ownership of the 
+    // lock to hand it over
     else { 
         
       _waiters.insert(self);
+
       m.acquire();
+      self->_signalable = true;
 
       Behavior::waiterArrived(self);
 
-      {        
-      
+      {
+
         Guard<FastLock, UnlockedScope> g2(g1);
-        state = m.wait();
-      
+
+        // The monitor is sticky, so its possible a state 'stuck' from a
+        // previous operation will end the wait() before release() has 
+        // picked this thread. Keep waiting if that happens.
+        do {
+          state = m.wait();
+        } while(state == Monitor::SIGNALED && self->_signalable);
+
+        // A waiter that was picked was handed the mutex, even if its wait 
+        // ended for another reason (e.g. interrupted) just before
+        if(!self->_signalable)
+          state = acceptHandoff(m, state);
+
+        self->_signalable = false;
+
+        // Let go of the monitor before moving back to the lock
+        m.release();
+
       }
 
       Behavior::waiterDeparted(self);
 
-      m.release();
-        
-      // Remove from waiter list, regardless of wether release() is called or
-      // not. The monitor is sticky, so its possible a state 'stuck' from a
-      // previous operation and will leave the wait() w/o release() having
-      // been called (e.g. interrupted)
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
-
-      // If awoke due to a notify(), take ownership. 
+      // release() takes the waiter it picks off the list
+      if(state != Monitor::SIGNALED)
+        _waiters.remove(self);
+
       switch(state) {
         case Monitor::SIGNALED:
 
-          assert(_owner == 0);
-          _owner = self;    
+          assert(_owner == self);
 
           Behavior::ownerAcquired(self);
 
@@ -213,13 +365,16 @@ void MutexImpl<List, Behavior>::acquire() {
    * thread holds an exclusive lock on this mutex. If the lock cannot be
    * obtained before the timeout expires, the caller returns false.
    *
+   * @param timeout - number of milliseconds, or a Deadline
+   *
    * @exception Deadlock_Exception thrown when the caller attempts to acquire() more
    * than once, If the checking flag is set.
    * @exception Interrupted_Exception thrown when the caller status is interrupted
    * @exception Synchronization_Exception thrown if there is some other error.
    */
 template<typename List, typename Behavior> 
-bool MutexImpl<List, Behavior>::tryAcquire(unsigned long timeout) {
+template <class Timeout>
+bool MutexImpl<List, Behavior>::tryAcquire(const Timeout& timeout) {
   
     ThreadImpl* self = ThreadImpl::current();
     Monitor& m = self->getMonitor();
@@ -231,6 +386,10 @@ bool MutexImpl<List, Behavior>::tryAcquire(unsigned long timeout) {
     if(_owner == self) 
       throw Deadlock_Exception();
 
+    // Give a briefly held lock a chance to be released before parking
+    if(_owner != 0 && _waiters.empty() && !expired(timeout))
+      spin(g1);
+
     // Acquire the lock if it is free and there are no waiting threads
     if(_owner == 0 && _waiters.empty()) {
 
@@ -240,49 +399,55 @@ bool MutexImpl<List, Behavior>::tryAcquire(unsigned long timeout) {
       
     }
 
-    // Otherwise, wait for a signal from a thread releasing its
-    // ownership of the lock
+    // Don't bother waiting if the timeout has already expired
+    else if(expired(timeout))
+      return false;
+
+    // Otherwise, wait for a thread releasing its ownership of the 
+    // lock to hand it over
     else {
         
       _waiters.insert(self);
-    
-      Monitor::STATE state = Monitor::TIMEDOUT;
-    
-      // Don't bother waiting if the timeout is 0
-      if(timeout) {
-      
-        m.acquire();
 
-        Behavior::waiterArrived(self);
-      
-        {
-        
-          Guard<FastLock, UnlockedScope> g2(g1);
+      m.acquire();
+      self->_signalable = true;
+
+      Behavior::waiterArrived(self);
+
+      Monitor::STATE state;
+
+      {
+
+        Guard<FastLock, UnlockedScope> g2(g1);
+
+        // Keep waiting if a state 'stuck' from a previous operation ends 
+        // the wait() before release() has picked this thread
+        do {
           state = m.wait(timeout);
-        
-        }
+        } while(state == Monitor::SIGNALED && self->_signalable);
 
-        Behavior::waiterDeparted(self);
-      
+        // A waiter that was picked was handed the mutex, even if its wait 
+        // ended for another reason (e.g. timed out) just before
+        if(!self->_signalable)
+          state = acceptHandoff(m, state);
+
+        self->_signalable = false;
+
+        // Let go of the monitor before moving back to the lock
         m.release();
-        
+
       }
+
+      Behavior::waiterDeparted(self);
+
+      // release() takes the waiter it picks off the list
+      if(state != Monitor::SIGNALED)
+        _waiters.remove(self);
     
-    
-      // Remove from waiter list, regarless of weather release() is called or
-      // not. The monitor is sticky, so its possible a state 'stuck' from a
-      // previous operation and will leave the wait() w/o release() having
-      // been called.
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
-    
-      // If awoke due to a notify(), take ownership. 
       switch(state) {
         case Monitor::SIGNALED:
         
-          assert(0 == _owner);
-          _owner = self;
+          assert(_owner == self);
 
           Behavior::ownerAcquired(self);
         
@@ -304,6 +469,36 @@ bool MutexImpl<List, Behavior>::tryAcquire(unsigned long timeout) {
   
   }
 
+  /**
+   * Spin, with the lock released, until the mutex is released or the spin 
+   * limit given by the Behavior runs out. The caller still has to check 
+   * whether the mutex is free once this returns.
+   */
+template<typename List, typename Behavior> 
+void MutexImpl<List, Behavior>::spin(Guard<FastLock>& g1) {
+
+    int limit = Behavior::spinLimit();
+    if(limit == 0)
+      return;
+
+    int n = 0;
+
+    {
+
+      Guard<FastLock, UnlockedScope> g2(g1);
+
+      for(; n < limit && _owner != 0; ++n) {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+        __asm__ __volatile__("pause" ::: "memory");
+#endif
+      }
+
+    }
+
+    Behavior::spinCompleted(n, _owner == 0);
+
+  }
+
   /**
    * Release a lock on the mutex. If this operation succeeds the calling
    * thread no longer holds an exclusive lock on this mutex. If there are 
@@ -328,39 +523,23 @@ void MutexImpl<List, Behavior>::release() {
 
     Behavior::ownerReleased(impl);
   
-    // Try to find a waiter with a backoff & retry scheme
-    for(;;) {
-    
-      // Go through the list, attempt to notify() a waiter.
-      for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
-      
-        // Try the monitor lock, if it cant be locked skip to the next waiter
-        impl = *i;
-        Monitor& m = impl->getMonitor();
+    // Hand the mutex to the first waiter that accepts it. Waiters that 
+    // decline it are ending their wait anyway (interrupted/timed out)
+    for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
 
-        if(m.tryAcquire()) {
-  
-          // If notify() is not sucessful, it is because the wait() has already 
-          // been ended (killed/interrupted/notify'd)
-          bool woke = m.notify();
-          
-          m.release();
-        
-          // Once notify() succeeds, return
-          if(woke)
-            return;
-        
-        } else ++i;
-      
-      }
-    
-      if(_waiters.empty())
-        return;
+      impl = *i;
+      i = _waiters.erase(i);
 
-      { // Backoff and try again
-      
-        Guard<FastLock, UnlockedScope> g2(g1);
-        ThreadImpl::yield();
+      Monitor& m = impl->getMonitor();
+      Guard<Monitor> g2(m);
+
+      // notify() fails only when the waiter is interrupted
+      if(impl->_signalable && m.notify()) {
+
+        impl->_signalable = false;
+        _owner = impl;
+
+        return;
 
       }
 
@@ -368,6 +547,51 @@ void MutexImpl<List, Behavior>::release() {
   
   }
 
+  /**
+   * Add a thread blocked on a ConditionImpl to the waiters for this mutex.
+   * It will be woken once release() hands the mutex to it.
+   *
+   * @see RequeueTarget::requeue()
+   */
+template<typename List, typename Behavior> 
+bool MutexImpl<List, Behavior>::requeue(ThreadImpl* impl) {
+
+    Guard<FastLock> g1(_lock);
+
+    if(_owner == 0)
+      return false;
+
+    _waiters.insert(impl);
+
+    Behavior::waiterArrived(impl);
+
+    return true;
+
+  }
+
+  /**
+   * @see RequeueTarget::departed()
+   */
+template<typename List, typename Behavior> 
+void MutexImpl<List, Behavior>::departed(ThreadImpl* self, bool handed) {
+
+    Guard<FastLock> g1(_lock);
+
+    Behavior::waiterDeparted(self);
+
+    if(!handed) {
+
+      _waiters.remove(self);
+      return;
+
+    }
+
+    assert(_owner == self);
+
+    Behavior::ownerAcquired(self);
+
+  }
+
 } // namespace ZThread
 
 
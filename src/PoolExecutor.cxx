@@ -24,8 +24,11 @@
 #include "zthread/PoolExecutor.h"
 #include "zthread/MonitoredQueue.h"
 #include "zthread/FastMutex.h"
+#include "zthread/Condition.h"
 #include "ThreadImpl.h"
 #include "ThreadQueue.h"
+#include "StealingDeque.h"
+#include "TSS.h"
 
 #include <algorithm>
 #include <deque>
@@ -38,272 +41,178 @@ namespace ZThread {
   namespace {
 
     /**
+     * @class WaiterQueue
+     *
+     * Tracks the tasks that are outstanding so that wait() can block until every 
+     * task submitted before it has completed. 
+     *
+     * Tasks are counted in one of two slots, chosen by the low bit of the current 
+     * epoch. Submitting or completing a task is one atomic update of a slot; the 
+     * lock is only taken by wait() and by the completion of the last task in a 
+     * slot while there are waiters.
+     *
+     * A waiter advances the epoch once the other slot has drained, so that new 
+     * tasks stop landing in the slot it is waiting on. Since the epoch only moves 
+     * from e to e+1 once every task from epoch e-1 has completed, a waiter that 
+     * arrived during epoch a is done once the epoch reaches a+2, or once it 
+     * reaches a+1 and the slot for epoch a is empty.
+     *
+     * Without atomic builtins the slots, the count of waiters and the 
+     * generation are updated under a lock of their own instead.
      */
     class WaiterQueue {
 
-      typedef std::deque<ThreadImpl*>  ThreadList;
-      
-      typedef struct group_t {
-        size_t     id;
-        size_t     count;
-        ThreadList waiters;
-        group_t(size_t n) : id(n), count(0) {}
-      } Group;
-
-      typedef std::deque<Group>  GroupList;
-
-      //! Predicate to find a specific group
-      struct by_id : public std::unary_function<bool, Group> {
-        size_t id;
-        by_id(size_t n) : id(n) {}
-        bool operator()(const Group& grp) {
-          return grp.id == id;
+      FastMutex _lock;
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+      FastLock _countLock;
+#endif
+
+      //! Signaled when a slot drains while there are waiters
+      Condition _drained;
+
+      //! Current epoch, only advanced by waiters while holding _lock
+      volatile size_t _epoch;
+
+      //! Outstanding tasks for the current and the previous epoch
+      volatile size_t _count[2];
+
+      //! Threads blocked in wait()
+      volatile size_t _waiters;
+
+      volatile size_t _generation;
+
+      /**
+       * Add to a count. Each call is a full barrier, so a waiter counting 
+       * itself and a task draining a slot cannot both miss each other.
+       *
+       * @return size_t the count before the addition
+       */
+      size_t add(volatile size_t& count, size_t n) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+        return __sync_fetch_and_add(&count, n);
+#else
+        Guard<FastLock> g(_countLock);
+
+        size_t previous = count;
+        count = previous + n;
+
+        return previous;
+#endif
+
+      }
+
+      //! Count a waiter for as long as it holds the lock
+      class Waiting {
+
+        WaiterQueue& _queue;
+
+      public:
+
+        Waiting(WaiterQueue& queue) : _queue(queue) { 
+          _queue.add(_queue._waiters, 1);
+        }
+
+        ~Waiting() { 
+          _queue.add(_queue._waiters, (size_t)-1);
         }
-      };
 
-      //! Functor to count groups
-      struct counter : public std::unary_function<void, Group> {
-        size_t count;
-        counter() : count(0) {}
-        void operator()(const Group& grp) { count += grp.count; }
-        operator size_t() { return count; }
       };
-      
-      FastMutex     _lock;
-      GroupList _list;
-      size_t    _id;
-      size_t    _generation;
+
+      friend class Waiting;
 
     public:
       
-      WaiterQueue() : _id(0), _generation(0) {
-        // At least one empty-group exists
-        _list.push_back( Group(_id++) );
+      WaiterQueue() : _drained(_lock), _epoch(0), _waiters(0), _generation(0) {
+        _count[0] = _count[1] = 0;
       }
 
       /**
-       * Insert the current thread into the current waiter list
+       * Block the current thread until every task counted before this call 
+       * has completed.
+       *
+       * @param timeout maximum time to block (milliseconds) or 0 to block 
+       *        indefinitely
        *
-       * @pre  At least one empty group exists
-       * @post At least one empty group exists
+       * @return false if the timeout expired
        */
       bool wait(unsigned long timeout) {
 
-		ThreadImpl* current = ThreadImpl::current();
-        Monitor& m = current->getMonitor();
-
-        Monitor::STATE state;
+        Guard<FastMutex> g(_lock);
+        Waiting w(*this);
 
-        Guard<FastMutex> g1(_lock);
+        size_t a = _epoch;
 
-        // At least one empty-group exists
-        assert(!_list.empty());
+        for(;;) {
 
-        // Return w/o waiting if there are no executing tasks
-        if((size_t)std::for_each(_list.begin(), _list.end(), counter()) < 1)
-          return true;
+          size_t e = _epoch;
 
-        // Update the waiter list for the active group 
-        _list.back().waiters.push_back(current);
-        size_t n = _list.back().id;
+          if(e - a >= 2)
+            break;
 
-        m.acquire();
-        
-        {
+          if(e != a) {
 
-          Guard<FastMutex, UnlockedScope> g2(g1);          
-          state = timeout == 0 ? m.wait() : m.wait(timeout);
+            // Every task from epoch a-1 has completed, only epoch a remains
+            if(_count[a & 1] == 0)
+              break;
 
-        }
+          } else if(_count[(a + 1) & 1] == 0) {
 
-        m.release();
+            // Every task from epoch a-1 has completed, move new tasks to the
+            // other slot and wait for epoch a to drain
+            _epoch = a + 1;
+            continue;
 
-        // If awoke due to a reason other than the last task in the group 'n' completing,
-        // then then find the group 'current' is waiting in
-        GroupList::iterator i = std::find_if(_list.begin(), _list.end(), by_id(n));
-        if(i != _list.end()) {
+          }
 
-          // Remove 'current' from that list if it is still a member
-          ThreadList::iterator j = std::find(i->waiters.begin(), i->waiters.end(), current);
-          if(j != i->waiters.end())
-            i->waiters.erase(j);
+          if(timeout == 0)
+            _drained.wait();
+          else if(!_drained.wait(timeout))
+            return false;
 
         }
 
-        // At least one empty-group exists
-        assert(!_list.empty());
-
-        switch(state) {
-          case Monitor::SIGNALED:
-            break;
-          case Monitor::TIMEDOUT:
-            return false;
-          case Monitor::INTERRUPTED:
-            throw Interrupted_Exception();
-          default:
-            throw Synchronization_Exception();
-        } 
-       
         return true;
 
       }
       
       /**
-       * Increment the active group count
+       * Count a new task
        *
-       * @pre at least 1 empty group exists
-       * @post at least 1 non-empty group exists 
+       * @return the slot the task was counted in, and the current generation
        */
       std::pair<size_t, size_t> increment() {
-        
-        Guard<FastMutex> g(_lock);
-        
-        // At least one empty-group exists
-        assert(!_list.empty());
-
-        GroupList::iterator i = --_list.end();
-        size_t n = i->id;
 
-        if(i == _list.end()) {
+        size_t n = _epoch & 1;
+        add(_count[n], 1);
 
-          // A group should never have been removed until
-          // the final task in that group completed
-          assert(0);
-
-        }
-
-        i->count++;
-
-        // When the active group is being incremented, insert a new active group
-        // to replace it if there were waiting threads
-        if(i == --_list.end() && !i->waiters.empty()) 
-          _list.push_back(Group(_id++));
-
-        // At least 1 non-empty group exists
-        assert((size_t)std::for_each(_list.begin(), _list.end(), counter()) > 0);
-
-        return std::make_pair(n, _generation);
+        return std::make_pair(n, (size_t)_generation);
 
       }
       
 
       /**
-       * Decrease the count for the group with the given id.
+       * Count the completion of a task
        *
-       * @param n group id
-       * 
-       * @pre  At least 1 non-empty group exists
-       * @post At least 1 empty group exists
+       * @param n slot returned by increment()
        */
       void decrement(size_t n) {
-       
-        Guard<FastMutex> g1(_lock);
-       
-        // At least 1 non-empty group exists
-        assert((size_t)std::for_each(_list.begin(), _list.end(), counter()) > 0);
-
-        // Find the requested group
-        GroupList::iterator i = std::find_if(_list.begin(), _list.end(), by_id(n));
-        if(i == _list.end()) {
-          
-          // A group should never have been removed until
-          // the final task in that group completed
-          assert(0);
-
-        }
-
-        // Decrease the count for tasks in this group,
-        if(--i->count == 0 && i == _list.begin()) {
-       
-          do { 
-
-            // When the first group completes, wake all waiters for every
-            // group, starting from the first until a group that is not 
-            // complete is reached
-
-            /*
-            // Don't remove the empty active group
-            if(i == --_list.end() && i->waiters.empty())
-              break;
-            */
-            
-            if( awaken(*i) ) {
-            
-              // If all waiters were awakened, remove the group  
-              i = _list.erase(i);
-              
-            } else {
-              
-              {
-
-                // Otherwise, unlock and yield allowing the waiter
-                // lists to be updated if other threads are busy
-                Guard<FastLock, UnlockedScope> g2(g1);
-                ThreadImpl::yield();
-              
-              }
 
-              i = _list.begin();
+        // Wake the waiters when a slot drains
+        if(add(_count[n], (size_t)-1) == 1 && _waiters > 0) {
 
-            }
-              
-          } while(i != _list.end() && i->count == 0); 
-          
-          // Ensure that an active group exists
-          if(_list.empty())
-            _list.push_back( Group(++_id) );
+          Guard<FastMutex> g(_lock);
+          _drained.broadcast();
 
         }
 
-        // At least one group exists
-        assert(!_list.empty());
-        
       }
 
       /**
        */
       size_t generation(bool next = false) {
-
-        Guard<FastMutex> g(_lock);
-        return next ? _generation++ : _generation;
-
-      }
-      
-    private:
-      
-      /**
-       * Awaken all the waiters remaining in the given group
-       * 
-       * @return
-       *   - true if all the waiting threads were successfully awakened.
-       *   - false if there were one or more threads that could not be awakened.
-       */
-      bool awaken(Group& grp) {
-
-        // Go through the waiter list in the given group; 
-        for(ThreadList::iterator i = grp.waiters.begin(); i != grp.waiters.end();) {
-          
-          ThreadImpl* impl = *i;
-          Monitor& m = impl->getMonitor();
-          
-          // Try the monitor lock, if it cant be locked skip to the next waiter
-          if(m.tryAcquire()) {
-            
-            // Notify the monitor & remove from the waiter list so time isn't
-            // wasted checking it again.
-            i = grp.waiters.erase(i);
-            
-            // Try to wake the waiter, it doesn't matter if this is successful
-            // or not (only fails when the monitor is already going to stop waiting). 
-            m.notify();
-            m.release();
-            
-          } else ++i;
-          
-        }
-        
-        return grp.waiters.empty();
-
+        return next ? add(_generation, 1) : _generation;
       }
 
     };
@@ -313,31 +222,47 @@ namespace ZThread {
      * 
      * Wrap a task with group and generation information. 
      *
-     * - 'group' allows tasks to be grouped together so that lists of waiting
-     *   threads can be managed.
+     * - 'group' is the WaiterQueue slot the task is counted in, so that
+     *   waiting threads can tell when it has completed.
      *
      * - 'generation' allows tasks to be interrupted  
+     *
+     * GroupedRunnables are recycled by the executor once they have run, so 
+     * that submitting a task does not allocate. 
      */
     class GroupedRunnable : public Runnable {
 
       Task _task;
-      WaiterQueue& _queue;
+      WaiterQueue* _queue;
 
       size_t _group;
       size_t _generation;
 
     public:
 
-      GroupedRunnable(const Task& task, WaiterQueue& queue)
-        : _task(task), _queue(queue) { 
+      //! Link used by the TaskList and by free lists
+      GroupedRunnable* next;
+
+      GroupedRunnable() : _task(CountedPtr<Runnable, AtomicCount>()), _queue(0), next(0) { }
+
+      //! Wrap a new task and count it with the given WaiterQueue
+      void assign(const Task& task, WaiterQueue& queue) {
+
+        _task  = task;
+        _queue = &queue;
         
-        std::pair<size_t, size_t> pr( _queue.increment() );
+        std::pair<size_t, size_t> pr( _queue->increment() );
     
         _group      = pr.first;
         _generation = pr.second;
 
       }
 
+      //! Drop the reference to the task, before recycling 
+      void clear() {
+        _task.reset();
+      }
+
       size_t group() const {
         return _group;
       }
@@ -356,72 +281,274 @@ namespace ZThread {
 
         }
 
-        _queue.decrement( group() );
+        _queue->decrement( group() );
+
+      }
+
+    };
+
+    /**
+     * @class TaskList
+     *
+     * Storage for the shared task queue, GroupedRunnables are linked through 
+     * their own nodes so queueing a task does not allocate.
+     */
+    class TaskList {
+
+      GroupedRunnable* _head;
+      GroupedRunnable* _tail;
+      size_t _size;
+
+    public:
+
+      TaskList() : _head(0), _tail(0), _size(0) { }
+
+      void push_back(GroupedRunnable* r) {
+
+        r->next = 0;
+
+        if(_tail)
+          _tail->next = r;
+        else
+          _head = r;
+
+        _tail = r;
+        ++_size;
+
+      }
 
+      GroupedRunnable* front() const {
+        return _head;
+      }
+
+      void pop_front() {
+
+        _head = _head->next;
+        if(_head == 0)
+          _tail = 0;
+
+        --_size;
+
+      }
+
+      size_t size() const {
+        return _size;
+      }
+
+      bool empty() const {
+        return _head == 0;
       }
 
     };
 
-    typedef CountedPtr<GroupedRunnable, size_t> ExecutorTask;
+    /**
+     * @class LocalQueue
+     *
+     * State kept by each worker thread: the tasks it submitted in a work stealing 
+     * PoolExecutor, and a cache of free GroupedRunnables. LocalQueues are linked 
+     * together so idle workers can steal from them, and they are not freed until 
+     * the executor is. A LocalQueue left by a worker that exits is reused by the 
+     * next worker to start.
+     */
+    struct LocalQueue {
+
+      StealingDeque<GroupedRunnable*> deque;
+
+      //! Executor this queue belongs to
+      ExecutorImpl* pool;
+
+      //! Next queue in the executor
+      LocalQueue* next;
+
+      //! Set while a worker owns the queue
+      bool claimed;
+
+      //! Recycled GroupedRunnables, taken by other threads once the shared list runs dry
+      FastLock freeLock;
+      GroupedRunnable* free;
+      size_t freeCount;
+
+      LocalQueue(ExecutorImpl* impl, LocalQueue* link) 
+        : pool(impl), next(link), claimed(false), free(0), freeCount(0) { }
+
+    };
+
+    //! LocalQueue owned by the current worker thread, if any
+    TSS<LocalQueue*> _localQueue;
 
     /**
      *
      */
     class ExecutorImpl {
       
-      typedef MonitoredQueue<ExecutorTask, FastMutex> TaskQueue;
+      typedef MonitoredQueue<GroupedRunnable*, FastMutex, TaskList> TaskQueue;
+
+      //! Number of free GroupedRunnables a worker caches before sharing them
+      enum { CACHE_SIZE = 64 };
       typedef std::deque<ThreadImpl*> ThreadList;
       
       TaskQueue   _taskQueue;
       WaiterQueue _waitingQueue;
 
       ThreadList      _threads;
-      volatile size_t _size;
 
+      //! Worker threads running or starting, bounded by _min and _max
+      volatile size_t _live;
+      volatile size_t _min;
+      volatile size_t _max;
+
+      //! Time (ms) an idle worker above the minimum waits before it exits, 0 to wait forever
+      unsigned long _keepAlive;
+
+      //! Workers are started and retired as the load changes
+      bool _elastic;
+
+      //! Workers keep their own LocalQueues and steal from each other
+      bool _stealing;
+
+      //! Every LocalQueue for this executor
+      LocalQueue* volatile _locals;
+
+      //! Workers blocked on the shared queue
+      volatile int _idle;
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+      //! Orders the count of idle workers against pushLocal() without atomic builtins
+      FastLock _idleLock;
+#endif
+
+      //! Set once cancel() is called
+      volatile bool _canceled;
+
+      //! Recycled GroupedRunnables shared by all threads
+      FastLock _freeLock;
+      GroupedRunnable* _free;
 
     public:
       
-      ExecutorImpl() : _size(0) {}
+      ExecutorImpl(bool stealing, size_t min, size_t max, unsigned long keepAlive) 
+        : _live(0), _min(min), _max(max), _keepAlive(keepAlive), _elastic(min < max), 
+          _stealing(stealing), _locals(0), _idle(0), _canceled(false), _free(0) {}
+
+      ~ExecutorImpl() {
+
+        // Tasks that were never run
+        while(_taskQueue.size() > 0)
+          delete _taskQueue.next();
+
+        while(_locals) {
+
+          LocalQueue* q = _locals;
+          _locals = q->next;
+
+          assert(q->deque.empty());
+          release(q->free);
+
+          delete q;
+
+        }
+
+        release(_free);
+
+      }
 
 
       void registerThread() {
         
         Guard<TaskQueue> g(_taskQueue);
 
-        ThreadImpl* impl = ThreadImpl::current();
-        _threads.push_back(impl);
+        _threads.push_back(ThreadImpl::current());
+
+        // Reuse a LocalQueue left behind by a worker that has exited
+        LocalQueue* q = _locals;
+        while(q && q->claimed)
+          q = q->next;
+
+        if(q == 0) {
+
+          q = new LocalQueue(this, _locals);
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+          // Link the queue only once it is complete, thieves do not lock
+          __sync_synchronize();
+#endif
+          _locals = q;
+
+        }
 
-        // current cancel if too many threads are being created
-        if(_threads.size() > _size) 
-          impl->cancel();
+        q->claimed = true;
+        _localQueue.set(q);
 
       }
 
-      void unregisterThread() {
+      /**
+       * @param retired true if retire() already removed the thread from the
+       *        count of live workers
+       */
+      void unregisterThread(bool retired) {
+
+        LocalQueue* q = _localQueue.get();
+
+        // Run whatever is left in the local queue, those tasks were
+        // accepted and nobody else may be around to steal them
+        while(GroupedRunnable* r = q->deque.pop())
+          run(r);
+
+        // Share the cached GroupedRunnables
+        share(q);
+
+        _localQueue.set(0);
 
         Guard<TaskQueue> g(_taskQueue);
-        std::remove(_threads.begin(), _threads.end(), ThreadImpl::current());
+        q->claimed = false;
+
+        if(!retired)
+          --_live;
+
+        _threads.erase(std::remove(_threads.begin(), _threads.end(), ThreadImpl::current()), _threads.end());
 
       }
 
-      void execute(const Task& task) {
+      /**
+       * Queue a task.
+       *
+       * @return bool true if another worker was reserved, and should be started
+       */
+      bool execute(const Task& task) {
 
         // Wrap the task with a grouped task
-        GroupedRunnable* runnable = new GroupedRunnable(task, _waitingQueue);
+        GroupedRunnable* runnable = allocate();
+        runnable->assign(task, _waitingQueue);
+
+        // Workers keep the tasks they submit when they can
+        if(_stealing && (runnable = pushLocal(runnable)) == 0)
+          return false;
  
         try {
           
-          _taskQueue.add( ExecutorTask(runnable) );
+          _taskQueue.add( runnable );
 
         } catch(...) {
 
           // Incase the queue is canceled between the time the WaiterQueue is 
           // updated and the task is added to the TaskQueue
           _waitingQueue.decrement( runnable->group() );
+          recycle(runnable);
+
           throw;
 
         }
 
+        return _elastic && grow();
+
+      }
+
+      //! Run a task drawn by next() and recycle it
+      void run(GroupedRunnable* task) {
+
+        task->run();
+        recycle(task);
+
       }
 
       void interrupt() {
@@ -438,13 +565,23 @@ namespace ZThread {
        
       }
 
-      //! Adjust the number of desired workers and return the number of Threads needed
+      /**
+       * Adjust the minimum number of workers, and the maximum if it is exceeded 
+       * or the pool is not elastic. Surplus workers retire the next time they 
+       * look for a task.
+       *
+       * @return size_t number of workers reserved, that should be started
+       */
       size_t workers(size_t n) {
         
         Guard<TaskQueue> g(_taskQueue);
 
-        size_t m = (_size < n) ? (n - _size) : 0;
-        _size = n;
+        _min = n;
+        if(!_elastic || _max < n)
+          _max = n;
+
+        size_t m = (_live < n) ? (n - _live) : 0;
+        _live += m;
         
         return m;
 
@@ -453,20 +590,69 @@ namespace ZThread {
       size_t workers() {
         
         Guard<TaskQueue> g(_taskQueue);
-        return _size;
+        return _live;
         
       }
+
+      //! Give up a worker reserved by workers() or execute() that could not be started
+      void abandon() {
+
+        Guard<TaskQueue> g(_taskQueue);
+        --_live;
+
+      }
       
-      ExecutorTask next() {
+      /**
+       * Get the next task for the current worker.
+       *
+       * @return GroupedRunnable* the next task, or 0 if the worker has retired
+       */
+      GroupedRunnable* next() {
         
-        ExecutorTask task;
+        GroupedRunnable* task = 0;
         
         // Draw the task from the queue
         for(;;) {
 
           try { 
 
-            task = _taskQueue.next();
+            if(_stealing)
+              task = take();
+
+            if(task == 0) {
+
+              // Leave rather than wait when there are more workers than allowed
+              if(retire(_max))
+                return 0;
+
+              if(!_stealing && !_elastic)
+                task = _taskQueue.next();
+
+              else {
+
+                // Become idle before looking one last time, a worker pushing a 
+                // task locally will either see this worker is idle or the task 
+                // will be found here
+                idle(1);
+
+                try {
+
+                  if(!_stealing || (task = take()) == 0)
+                    task = _keepAlive ? _taskQueue.next(_keepAlive) : _taskQueue.next();
+
+                } catch(...) {
+
+                  idle(-1);
+                  throw;
+
+                }
+
+                idle(-1);
+
+              }
+
+            }
+
             break;
 
           } catch(Interrupted_Exception&) {
@@ -476,6 +662,12 @@ namespace ZThread {
             // thread was interrupted in the hopes it was busy 
             // with a task
 
+          } catch(Timeout_Exception&) {
+
+            // Idle for the keep alive time, leave if the pool can shrink
+            if(retire(_min))
+              return 0;
+
           }
 
         }
@@ -499,13 +691,321 @@ namespace ZThread {
       }
 
       void cancel() {
+
+        _canceled = true;
         _taskQueue.cancel();
+
       }
 
       bool wait(unsigned long timeout) {
         return _waitingQueue.wait(timeout);
       }
 
+    private:
+
+      /**
+       * Reserve another worker when queued tasks outnumber the idle workers 
+       * and the pool is below its maximum size.
+       *
+       * @return bool true if a worker was reserved
+       */
+      bool grow() {
+
+        if(_live >= _max || _taskQueue.size() <= (size_t)_idle)
+          return false;
+
+        Guard<TaskQueue> g(_taskQueue);
+
+        if(_live >= _max)
+          return false;
+
+        ++_live;
+        return true;
+
+      }
+
+      /**
+       * Retire the current worker if there are more live workers than the given bound.
+       *
+       * @return bool true if the worker should exit
+       */
+      bool retire(volatile size_t& bound) {
+
+        if(_live <= bound)
+          return false;
+
+        Guard<TaskQueue> g(_taskQueue);
+
+        if(_live <= bound)
+          return false;
+
+        --_live;
+        return true;
+
+      }
+
+      /**
+       * Push a task onto the current worker's LocalQueue.
+       *
+       * @return 0 if the task was queued, otherwise a task that must be added to 
+       *         the shared queue instead.
+       */
+      GroupedRunnable* pushLocal(GroupedRunnable* r) {
+
+        LocalQueue* q = _localQueue.get();
+
+        // Only workers of this executor have a LocalQueue, and idle workers 
+        // are better served by the shared queue
+        if(q == 0 || q->pool != this || _idle > 0 || _canceled || !q->deque.push(r))
+          return r;
+
+        // Publish the task before checking for idle workers again
+        if(idle(0) == 0)
+          return 0;
+
+        // A worker became idle while the task was pushed, hand a task over to it. 
+        // If nothing is left, a thief has taken it already.
+        return q->deque.pop();
+
+      }
+
+      /**
+       * Adjust the count of idle workers. Each call is a full barrier, so 
+       * a worker going idle and a worker pushing a task locally cannot both
+       * miss each other.
+       *
+       * @param n amount to add, 0 only reads the count
+       * @return int the count of idle workers after the adjustment
+       */
+      int idle(int n) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+        return __sync_add_and_fetch(&_idle, n);
+#else
+        Guard<FastLock> g(_idleLock);
+        return _idle += n;
+#endif
+
+      }
+
+      //! First LocalQueue of this executor, thieves walk the list from here
+      LocalQueue* locals() {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+        return _locals;
+#else
+        // Queues are linked under this lock, see registerThread()
+        Guard<TaskQueue> g(_taskQueue);
+        return _locals;
+#endif
+
+      }
+
+      /**
+       * Get a GroupedRunnable from the current worker's cache, or from the 
+       * shared free list. When both are empty the nodes cached by the other
+       * workers are gathered first, so a node is only allocated when every
+       * one is in use.
+       */
+      GroupedRunnable* allocate() {
+
+        LocalQueue* q = _localQueue.get();
+        bool local = (q != 0 && q->pool == this);
+
+        if(local) {
+
+          Guard<FastLock> g(q->freeLock);
+
+          GroupedRunnable* r = q->free;
+          if(r != 0) {
+
+            q->free = r->next;
+            q->freeCount--;
+
+            return r;
+
+          }
+
+        }
+
+        // Workers move a batch into their cache
+        size_t n = local ? CACHE_SIZE : 1;
+
+        GroupedRunnable* r = takeShared(n);
+        if(r == 0 && gather())
+          r = takeShared(n);
+
+        if(r == 0)
+          return new GroupedRunnable();
+
+        if(local && r->next) {
+
+          Guard<FastLock> g(q->freeLock);
+
+          GroupedRunnable* last = r->next;
+          while(last->next)
+            last = last->next;
+
+          last->next = q->free;
+          q->free = r->next;
+          q->freeCount += n - 1;
+
+        }
+
+        return r;
+
+      }
+
+      //! Return a GroupedRunnable to the current worker's cache, or to the shared free list
+      void recycle(GroupedRunnable* r) {
+
+        r->clear();
+        r->next = 0;
+
+        LocalQueue* q = _localQueue.get();
+
+        if(q != 0 && q->pool == this) {
+
+          {
+
+            Guard<FastLock> g(q->freeLock);
+
+            r->next = q->free;
+            q->free = r;
+
+            // Share the cache once it is full
+            if(++q->freeCount < 2 * CACHE_SIZE)
+              return;
+
+            r = q->free;
+            q->free = 0;
+            q->freeCount = 0;
+
+          }
+
+        }
+
+        putShared(r);
+
+      }
+
+      /**
+       * Detach up to n nodes from the shared free list.
+       *
+       * @param n [in] most nodes to take, [out] nodes taken
+       * @return GroupedRunnable* detached list, 0 if the shared list was empty
+       */
+      GroupedRunnable* takeShared(size_t& n) {
+
+        Guard<FastLock> g(_freeLock);
+
+        GroupedRunnable* r = _free;
+        if(r == 0)
+          return 0;
+
+        GroupedRunnable* last = r;
+        size_t count = 1;
+
+        for(; count < n && last->next; ++count)
+          last = last->next;
+
+        _free = last->next;
+        last->next = 0;
+
+        n = count;
+        return r;
+
+      }
+
+      //! Link a list of GroupedRunnables onto the shared free list
+      void putShared(GroupedRunnable* list) {
+
+        GroupedRunnable* last = list;
+        while(last->next)
+          last = last->next;
+
+        Guard<FastLock> g(_freeLock);
+
+        last->next = _free;
+        _free = list;
+
+      }
+
+      /**
+       * Move a worker's cache onto the shared free list
+       *
+       * @return bool true if the cache held any nodes
+       */
+      bool share(LocalQueue* q) {
+
+        GroupedRunnable* list;
+
+        {
+
+          Guard<FastLock> g(q->freeLock);
+
+          list = q->free;
+          q->free = 0;
+          q->freeCount = 0;
+
+        }
+
+        if(list == 0)
+          return false;
+
+        putShared(list);
+        return true;
+
+      }
+
+      /**
+       * Move the cache of every worker onto the shared free list. A cache 
+       * lock and the shared list lock are never held together.
+       *
+       * @return bool true if any nodes were moved
+       */
+      bool gather() {
+
+        bool found = false;
+
+        for(LocalQueue* p = locals(); p != 0; p = p->next)
+          found = share(p) || found;
+
+        return found;
+
+      }
+
+      //! Free a list of GroupedRunnables
+      static void release(GroupedRunnable* list) {
+
+        while(list) {
+
+          GroupedRunnable* r = list;
+          list = r->next;
+
+          delete r;
+
+        }
+
+      }
+
+      //! Pop from the current worker's LocalQueue, or steal from another worker
+      GroupedRunnable* take() {
+
+        LocalQueue* q = _localQueue.get();
+
+        GroupedRunnable* r = q->deque.pop();
+        if(r != 0)
+          return r;
+
+        for(LocalQueue* p = locals(); p != 0; p = p->next)
+          if(p != q && (r = p->deque.steal()) != 0)
+            return r;
+
+        return 0;
+
+      }
+
     };
 
     //! Executor job
@@ -519,26 +1019,61 @@ namespace ZThread {
       Worker(const CountedPtr< ExecutorImpl >& impl) 
         : _impl(impl) { }
    
-      //! Run until Thread or Queue are canceled
+      //! Run until Thread or Queue are canceled, or until the worker retires
       void run() { 
         
         _impl->registerThread();
+
+        bool retired = false;
         
-        // Run until the Queue is canceled
-        while(!Thread::canceled()) {
+        try {
+
+          // Run until the Queue is canceled
+          while(!Thread::canceled()) {
           
-          // Draw tasks from the queue
-          ExecutorTask task( _impl->next() );
-          task->run();
+            // Draw tasks from the queue
+            GroupedRunnable* task = _impl->next();
+
+            if(task == 0) {
+
+              retired = true;
+              break;
+
+            }
+
+            _impl->run( task );
                     
-        } 
+          } 
+
+        } catch(...) {
+
+          _impl->unregisterThread(retired);
+          throw;
+
+        }
         
-        _impl->unregisterThread();
+        _impl->unregisterThread(retired);
    
       }
       
     }; /* Worker */
 
+    //! Start a worker reserved with the ExecutorImpl
+    void spawn(CountedPtr< ExecutorImpl >& impl) {
+
+      try {
+
+        Thread t(new Worker(impl));
+
+      } catch(...) {
+
+        impl->abandon();
+        throw;
+
+      }
+
+    }
+
 
     //! Helper
     class Shutdown : public Runnable {
@@ -558,8 +1093,8 @@ namespace ZThread {
 
   }
 
-  PoolExecutor::PoolExecutor(size_t n)
-    : _impl( new ExecutorImpl() ), _shutdown( new Shutdown(_impl) ) {
+  PoolExecutor::PoolExecutor(size_t n, QueueMode mode)
+    : _impl( new ExecutorImpl(mode == STEALING, n, n, 0) ), _shutdown( new Shutdown(_impl) ) {
    
     size(n);
     
@@ -568,6 +1103,19 @@ namespace ZThread {
 
   }
 
+  PoolExecutor::PoolExecutor(size_t min, size_t max, unsigned long keepAlive, QueueMode mode)
+    : _impl( new ExecutorImpl(mode == STEALING, min, max, keepAlive) ), _shutdown( new Shutdown(_impl) ) {
+
+    if(max < min)
+      throw InvalidOp_Exception();
+   
+    size(min);
+    
+    // Request cancelation when main() exits
+    ThreadQueue::instance()->insertShutdownTask(_shutdown);
+
+  }
+
   PoolExecutor::~PoolExecutor() { 
 
     try {
@@ -593,7 +1141,7 @@ namespace ZThread {
       throw InvalidOp_Exception();
 
     for(size_t m = _impl->workers(n); m > 0; --m)
-      Thread t(new Worker(_impl));
+      spawn(_impl);
 
   }
 
@@ -605,8 +1153,10 @@ namespace ZThread {
   void PoolExecutor::execute(const Task& task) {
 
     // Enqueue the task, the Queue will reject it with a 
-    // Cancelation_Exception if the Executor has been canceled
-    _impl->execute(task); 
+    // Cancelation_Exception if the Executor has been canceled.
+    // An elastic pool may want another worker for it
+    if(_impl->execute(task))
+      spawn(_impl);
 
   }
 
@@ -61,6 +61,12 @@ namespace ZThread {
 
   }
 
+  bool PriorityCondition::wait(const Deadline& deadline) {
+
+    return _impl->wait(deadline);
+
+  }
+
 
 
   void PriorityCondition::signal() {
@@ -97,6 +97,12 @@ namespace ZThread {
 
   }
 
+  bool PriorityInheritanceMutex::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline); 
+
+  }
+
   // V
   void PriorityInheritanceMutex::release() {
 
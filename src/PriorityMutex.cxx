@@ -27,7 +27,11 @@
 
 namespace ZThread {
 
-  class PriorityMutexImpl : public MutexImpl<priority_list, NullBehavior> { };
+  class PriorityMutexImpl : public MutexImpl<priority_list, SpinningBehavior> { };
+
+  RequeueTarget* RequeueTarget::find(PriorityMutex& lock) {
+    return lock._impl;
+  }
 
   PriorityMutex::PriorityMutex() { 
   
@@ -57,6 +61,12 @@ namespace ZThread {
 
   }
 
+  bool PriorityMutex::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline); 
+
+  }
+
   // V
   void PriorityMutex::release() {
 
@@ -93,6 +93,13 @@ namespace ZThread {
     return _impl->tryAcquire(ms);
 
 
+  }
+
+  bool PrioritySemaphore::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline);
+
+
   }
 
   void PrioritySemaphore::release() {
@@ -26,66 +26,217 @@
 #include "ThreadImpl.h"
 
 #include <algorithm>
-#include <functional>
-#include <deque>
-#include <utility>
+#include <assert.h>
 
 namespace ZThread {
 
   /**
    * @author Eric Crahen <http://www.code-foo.com>
    * @date <2003-07-16T20:01:18-0400>
-   * @version 2.2.0
+   * @version 2.3.3
    * @class fifo_list
+   *
+   * Waiter list that links threads through the nodes embedded in each
+   * ThreadImpl. A thread waits in at most one list at a time, so insert(), 
+   * erase() and remove() are all O(1) and never allocate.
    */
-  class fifo_list : public std::deque<ThreadImpl*> {
+  class fifo_list {
+
+    ThreadImpl* _head;
+    ThreadImpl* _tail;
+    size_t _size;
+
   public:
 
-    void insert(const value_type& val) { push_back(val); }
+    typedef ThreadImpl* value_type;
+    typedef size_t size_type;
 
-  };
+    class iterator {
 
-  /**
-   * @author Eric Crahen <http://www.code-foo.com>
-   * @date <2003-07-16T20:01:18-0400>
-   * @version 2.2.0
-   * @struct priority_order
-   */
-  struct priority_order : public std::binary_function<ThreadImpl*, ThreadImpl*, bool> {
-   
-    std::less<const ThreadImpl*> id;
+      ThreadImpl* _impl;
+      friend class fifo_list;
+
+    public:
+
+      iterator(ThreadImpl* impl = 0) : _impl(impl) { }
+
+      ThreadImpl* operator*() const { return _impl; }
+
+      iterator& operator++() {
+        _impl = _impl->_nextWaiter;
+        return *this;
+      }
+
+      bool operator==(const iterator& i) const { return _impl == i._impl; }
+      bool operator!=(const iterator& i) const { return _impl != i._impl; }
+
+    };
+
+    fifo_list() : _head(0), _tail(0), _size(0) { }
+
+    iterator begin() const { return iterator(_head); }
+    iterator end() const { return iterator(); }
+
+    bool empty() const { return _head == 0; }
+    size_type size() const { return _size; }
+
+    void insert(const value_type& val) { 
 
-    bool operator()(const ThreadImpl* t0, const ThreadImpl* t1) const {
+      assert(val->_waitList == 0);
 
-      if(t0->getPriority() > t1->getPriority())
-        return true;
+      val->_waitList = this;
+      val->_nextWaiter = 0;
+      val->_prevWaiter = _tail;
 
-      else if (t0->getPriority() < t1->getPriority())
-        return false;
+      if(_tail)
+        _tail->_nextWaiter = val;
+      else
+        _head = val;
 
-      return id(t0, t1);
+      _tail = val;
+      ++_size;
 
     }
-  
-  };
 
+    //! Unlink the waiter, returning an iterator to the one that followed it
+    iterator erase(iterator i) {
+
+      ThreadImpl* impl = i._impl;
+      ThreadImpl* next = impl->_nextWaiter;
+
+      assert(impl->_waitList == this);
+
+      if(impl->_prevWaiter)
+        impl->_prevWaiter->_nextWaiter = next;
+      else
+        _head = next;
+
+      if(next)
+        next->_prevWaiter = impl->_prevWaiter;
+      else
+        _tail = impl->_prevWaiter;
+
+      impl->_nextWaiter = impl->_prevWaiter = 0;
+      impl->_waitList = 0;
+      --_size;
+
+      return iterator(next);
+
+    }
+
+    //! Unlink the waiter if it is still in this list
+    void remove(const value_type& val) {
+
+      if(val->_waitList == this)
+        erase(iterator(val));
+
+    }
+
+  };
 
   /**
    * @author Eric Crahen <http://www.code-foo.com>
    * @date <2003-07-16T20:01:18-0400>
-   * @version 2.2.0
+   * @version 2.3.3
    * @class priority_list
+   *
+   * Waiter list that keeps a fifo_list for each Priority. Waiters are 
+   * visited from the highest Priority to the lowest, and in arrival order 
+   * within a Priority. insert(), erase() and remove() are all O(1), finding 
+   * the first waiter is bounded by the number of Priority levels.
    */
-  class priority_list : public std::deque<ThreadImpl*> { 
+  class priority_list { 
+
+    enum { LEVELS = High + 1 };
 
-    priority_order comp;
+    //! Waiters for each Priority
+    fifo_list _buckets[LEVELS];
 
   public:
 
+    typedef ThreadImpl* value_type;
+    typedef size_t size_type;
+
+    class iterator {
+
+      const priority_list* _list;
+      int _level;
+      fifo_list::iterator _i;
+
+      friend class priority_list;
+
+      //! Move on to the next non-empty level when the current one runs out
+      void skip() {
+
+        while(_i == fifo_list::iterator() && --_level >= 0)
+          _i = _list->_buckets[_level].begin();
+
+      }
+
+    public:
+
+      iterator() : _list(0), _level(-1) { }
+
+      iterator(const priority_list* list, int level, fifo_list::iterator i) 
+        : _list(list), _level(level), _i(i) { skip(); }
+
+      ThreadImpl* operator*() const { return *_i; }
+
+      iterator& operator++() {
+
+        ++_i;
+        skip();
+
+        return *this;
+
+      }
+
+      bool operator==(const iterator& i) const { return _i == i._i; }
+      bool operator!=(const iterator& i) const { return _i != i._i; }
+
+    };
+
+    iterator begin() const { 
+      return iterator(this, LEVELS - 1, _buckets[LEVELS - 1].begin()); 
+    }
+
+    iterator end() const { return iterator(); }
+
+    bool empty() const { 
+
+      for(int n = 0; n < LEVELS; ++n)
+        if(!_buckets[n].empty())
+          return false;
+
+      return true;
+
+    }
+
+    size_type size() const { 
+
+      size_type sz = 0;
+      for(int n = 0; n < LEVELS; ++n)
+        sz += _buckets[n].size();
+
+      return sz;
+
+    }
+
     void insert(const value_type& val) { 
+      _buckets[val->getPriority()].insert(val);
+    }
+
+    //! Unlink the waiter, returning an iterator to the one that followed it
+    iterator erase(iterator i) {
+      return iterator(this, i._level, _buckets[i._level].erase(i._i));
+    }
+
+    //! Unlink the waiter if it is still in this list
+    void remove(const value_type& val) {
 
-      push_back(val); 
-      std::sort(begin(), end(), comp);
+      // The priority of a waiter can change after it is inserted
+      for(int n = 0; n < LEVELS; ++n)
+        _buckets[n].remove(val);
 
     }
 
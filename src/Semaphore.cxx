@@ -86,6 +86,12 @@ namespace ZThread {
 
   }
 
+  bool Semaphore::tryAcquire(const Deadline& deadline) {
+
+    return _impl->tryAcquire(deadline);
+
+  }
+
   void Semaphore::release() {
 
     _impl->release();
@@ -27,7 +27,9 @@
 
 #include "Debug.h"
 #include "FastLock.h"
+#include "MutexImpl.h"
 #include "Scheduling.h"
+#include "Timeout.h"
 
 #include <assert.h>
 
@@ -43,6 +45,12 @@ namespace ZThread {
    *
    * The SemaphoreImpl template allows how waiter lists are sorted
    * to be parameteized
+   *
+   * Waiters follow the protocol of the ConditionImpl: a waiter lets go of its 
+   * Monitor before it competes for the lock of the SemaphoreImpl again, so 
+   * release() can lock the Monitor of the waiter it picks without backing off. 
+   * A count handed to a waiter whose wait ended just before it was picked is 
+   * still taken by that waiter, so it is never lost.
    */
   template <typename List> 
     class SemaphoreImpl {
@@ -62,8 +70,8 @@ namespace ZThread {
     //! Flag for bounded or unbounded count
     volatile bool _checked;
 
-    //! Entry count
-    volatile int _entryCount;
+    //! Waiters that have been notified but have not yet taken their count
+    volatile int _signaled;
 
     public:
    
@@ -76,7 +84,7 @@ namespace ZThread {
      * properly allocated
      */
     SemaphoreImpl(int count, unsigned int maxCount, bool checked) 
-      : _count(count), _maxCount(maxCount), _checked(checked), _entryCount(0) { }
+      : _count(count), _maxCount(maxCount), _checked(checked), _signaled(0) { }
 
 
     ~SemaphoreImpl();
@@ -85,7 +93,8 @@ namespace ZThread {
   
     void release();
 
-    bool tryAcquire(unsigned long timeout);
+    template <class Timeout>
+    bool tryAcquire(const Timeout& timeout);
  
     int count();
 
@@ -142,41 +151,46 @@ namespace ZThread {
 
     Guard<FastLock> g1(_lock);
 
-    // Update the count without waiting if possible.
-    if(_count > 0 && _entryCount == 0)
+    // Update the count without waiting if possible, unless that count has 
+    // already been promised to a waiter that is waking up.
+    if(_count > _signaled)
       _count--;
 
     // Otherwise, wait() for the lock by placing the waiter in the list
     else {
 
-      ++_entryCount;
       _waiters.insert(self);
 
       m.acquire();
+      self->_signalable = true;
 
       {
       
         Guard<FastLock, UnlockedScope> g2(g1);
         state = m.wait();
+
+        // Take a count handed over after the wait ended
+        if(!self->_signalable)
+          state = acceptHandoff(m, state);
+
+        self->_signalable = false;
+
+        // Let go of the monitor before moving back to the lock
+        m.release();
       
       }
-
-      m.release();
         
       // Remove from waiter list, regarless of weather release() is called or
       // not. The monitor is sticky, so its possible a state 'stuck' from a
       // previous operation and will leave the wait() w/o release() having
       // been called.
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
-    
-      --_entryCount;
+      _waiters.remove(self);
 
       switch(state) {
         // If awoke due to a notify(), update the count
         case Monitor::SIGNALED:
             
+          --_signaled;
           _count--;           
           break;
            
@@ -195,12 +209,15 @@ namespace ZThread {
    * Decrement the count, blocking when it that count is 0 or less. If the timeout
    * expires before the count is raise above 0, the thread will stop blocking 
    * and return.
+   *
+   * @param timeout - number of milliseconds, or a Deadline
    * 
    * @exception Interrupted_Exception thrown when the caller status is interrupted
    * @exception Synchronization_Exception thrown if there is some other error.
    */
   template <typename List> 
-    bool SemaphoreImpl<List>::tryAcquire(unsigned long timeout) {
+  template <class Timeout>
+    bool SemaphoreImpl<List>::tryAcquire(const Timeout& timeout) {
  
     // Get the monitor for the current thread
     ThreadImpl* self = ThreadImpl::current();
@@ -208,31 +225,39 @@ namespace ZThread {
 
     Guard<FastLock> g1(_lock);
 
-    // Update the count without waiting if possible.
-    if(_count > 0 && _entryCount == 0)
+    // Update the count without waiting if possible, unless that count has 
+    // already been promised to a waiter that is waking up.
+    if(_count > _signaled)
       _count--;
 
     // Otherwise, wait() for the lock by placing the waiter in the list
     else {
     
-      ++_entryCount;
-      _waiters.push_back(self);
+      _waiters.insert(self);
 
       Monitor::STATE state = Monitor::TIMEDOUT;
 
-      // Don't bother waiting if the timeout is 0
-      if(timeout) {
+      // Don't bother waiting if the timeout has already expired
+      if(!expired(timeout)) {
         
         m.acquire();
+        self->_signalable = true;
 
         {
         
           Guard<FastLock, UnlockedScope> g2(g1);
           state = m.wait(timeout);
+
+          // Take a count handed over after the wait ended
+          if(!self->_signalable)
+            state = acceptHandoff(m, state);
+
+          self->_signalable = false;
+
+          // Let go of the monitor before moving back to the lock
+          m.release();
         
         }
-
-        m.release();
         
       }
         
@@ -240,16 +265,13 @@ namespace ZThread {
       // not. The monitor is sticky, so its possible a state 'stuck' from a
       // previous operation and will leave the wait() w/o release() having
       // been called.
-      typename List::iterator i = std::find(_waiters.begin(), _waiters.end(), self);
-      if(i != _waiters.end())
-        _waiters.erase(i);
-    
-      --_entryCount;
+      _waiters.remove(self);
 
       switch(state) {
         // If awoke due to a notify(), update the count
         case Monitor::SIGNALED:
             
+          --_signaled;
           _count--;           
           break;
            
@@ -289,43 +311,23 @@ namespace ZThread {
     // Increment the count
     _count++;
 
-    // Try to find a waiter with a backoff & retry scheme
-    for(;;) {
-    
-      // Go through the list, attempt to notify() a waiter.
-      for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
+    // Hand the count to the first waiter that accepts it. Waiters that 
+    // decline it are ending their wait anyway (interrupted/timed out)
+    for(typename List::iterator i = _waiters.begin(); i != _waiters.end();) {
 
-        // Try the monitor lock, if it cant be locked skip to the next waiter
-        ThreadImpl* impl = *i;
-        Monitor& m = impl->getMonitor();
+      ThreadImpl* impl = *i;
+      i = _waiters.erase(i);
+
+      Monitor& m = impl->getMonitor();
+      Guard<Monitor> g2(m);
+
+      // notify() fails only when the waiter is interrupted
+      if(impl->_signalable && m.notify()) {
+
+        impl->_signalable = false;
+        ++_signaled;
 
-        if(m.tryAcquire()) {
-        
-          // Notify the monitor & remove from the waiter list so time isn't
-          // wasted checking it again.
-          i = _waiters.erase(i);
-        
-          // If notify() is not sucessful, it is because the wait() has already 
-          // been ended (killed/interrupted/notify'd)
-          bool woke = m.notify();
-        
-          m.release();
-        
-          // Once notify() succeeds, return
-          if(woke) 
-            return;
-        
-        } else ++i;
-      
-      }
-    
-      if(_waiters.empty())
         return;
-    
-      { // Backoff and try again
-      
-        Guard<FastLock, UnlockedScope> g2(g1);
-        ThreadImpl::yield();
 
       }
 
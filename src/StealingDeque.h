@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTSTEALINGDEQUE_H__
+#define __ZTSTEALINGDEQUE_H__
+
+#include "zthread/AtomicCount.h"
+#include "zthread/NonCopyable.h"
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+#  include "zthread/Guard.h"
+#  include "FastLock.h"
+#endif
+
+namespace ZThread {
+
+  /**
+   * @class StealingDeque
+   * @version 2.3.3
+   *
+   * A fixed size work stealing deque (Chase & Lev). A single owning thread 
+   * push()es and pop()s at the bottom, while any number of other threads 
+   * can steal() from the top. The owner only contends with thieves when 
+   * one item is left.
+   *
+   * T must be a pointer type, a null T is used to report failure.
+   *
+   * Without atomic builtins each operation is made under a lock instead.
+   */
+  template <typename T, unsigned int Capacity = 1024>
+    class StealingDeque : private NonCopyable {
+
+    //! Capacity must be a power of 2
+    enum { MASK = Capacity - 1 };
+
+    volatile long _top;
+    volatile long _bottom;
+
+    T _items[Capacity];
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+    FastLock _lock;
+#endif
+
+    public:
+
+    StealingDeque() : _top(0), _bottom(0) { }
+
+    /**
+     * Add an item to the bottom of the deque. Called ONLY by the owner.
+     *
+     * @return false if the deque is full
+     */
+    bool push(T item) {
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+      Guard<FastLock> g(_lock);
+#endif
+
+      long b = _bottom;
+      if(b - _top >= (long)Capacity)
+        return false;
+
+      _items[b & MASK] = item;
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+      // Publish the item before the new bottom
+      __sync_synchronize();
+#endif
+      _bottom = b + 1;
+
+      return true;
+
+    }
+
+    /**
+     * Remove the most recently added item. Called ONLY by the owner.
+     *
+     * @return T, or 0 if the deque is empty
+     */
+    T pop() {
+
+#if !defined(ZT_INLINE_ATOMIC_COUNT)
+      Guard<FastLock> g(_lock);
+#endif
+
+      long b = _bottom - 1;
+      _bottom = b;
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+      // Reserve the bottom slot before looking for thieves
+      __sync_synchronize();
+#endif
+
+      long t = _top;
+      if(t > b) {
+
+        _bottom = t;
+        return 0;
+
+      }
+
+      T item = _items[b & MASK];
+
+      // Race the thieves for the last item
+      if(t == b) {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+        if(!__sync_bool_compare_and_swap(&_top, t, t + 1))
+          item = 0;
+#else
+        _top = t + 1;
+#endif
+
+        _bottom = t + 1;
+
+      }
+
+      return item;
+
+    }
+
+    /**
+     * Remove the least recently added item. May be called by any thread.
+     *
+     * @return T, or 0 if the deque is empty or another thread won the item
+     */
+    T steal() {
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+      long t = _top;
+      __sync_synchronize();
+      long b = _bottom;
+
+      if(t >= b)
+        return 0;
+
+      T item = _items[t & MASK];
+      if(!__sync_bool_compare_and_swap(&_top, t, t + 1))
+        return 0;
+
+      return item;
+
+#else
+
+      Guard<FastLock> g(_lock);
+
+      long t = _top;
+      if(t >= _bottom)
+        return 0;
+
+      _top = t + 1;
+      return _items[t & MASK];
+
+#endif
+
+    }
+
+    //! Test for items, the result is only a hint unless called by the owner
+    bool empty() const {
+      return _top >= _bottom;
+    }
+
+  }; /* StealingDeque */
+
+} // namespace ZThread
+
+#endif // __ZTSTEALINGDEQUE_H__
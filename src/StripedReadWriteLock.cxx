@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "zthread/StripedReadWriteLock.h"
+#include "zthread/AtomicCount.h"
+#include "zthread/Condition.h"
+#include "zthread/FastMutex.h"
+#include "zthread/Guard.h"
+#include "zthread/Mutex.h"
+#include "FastLock.h"
+#include "ThreadImpl.h"
+#include "Timeout.h"
+
+#if defined(ZT_WIN32) || defined(ZT_WIN9X)
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace ZThread {
+
+  namespace {
+
+    //! Space kept between stripes, so that each has a cache line of its own
+    const size_t CACHE_LINE = 64;
+
+    //! Bounds on the number of stripes chosen from the processor count
+    const unsigned int MIN_STRIPES = 4;
+    const unsigned int MAX_STRIPES = 64;
+
+    //! Number of processors available
+    unsigned int processors() {
+
+#if defined(ZT_WIN32) || defined(ZT_WIN9X)
+
+      SYSTEM_INFO info;
+      ::GetSystemInfo(&info);
+
+      return info.dwNumberOfProcessors;
+
+#elif defined(_SC_NPROCESSORS_ONLN)
+
+      long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+      return n > 0 ? (unsigned int)n : 1;
+
+#else
+
+      return 1;
+
+#endif
+
+    }
+
+    //! Round up to a power of 2
+    unsigned int roundUp(unsigned int n) {
+
+      unsigned int p = 1;
+      while(p < n)
+        p <<= 1;
+
+      return p;
+
+    }
+
+#if defined(ZT_INLINE_ATOMIC_COUNT)
+
+    //! Set the writer flag, ordered before the reads of the stripes that follow 
+    inline void announce(volatile int& flag) {
+      __sync_fetch_and_or(&flag, 1);
+    }
+
+    //! Clear the writer flag, ordered after the writes made under the lock
+    inline void retire(volatile int& flag) {
+      __sync_fetch_and_and(&flag, 0);
+    }
+
+    //! Order the accesses made under the write lock after the stripes drained
+    inline void fence() {
+      __sync_synchronize();
+    }
+
+    /**
+     * @class ReaderStripe
+     *
+     * Counts the readers that hash to it with atomic builtins; a reader arrives
+     * or departs with a single atomic instruction.
+     */
+    class ReaderStripe {
+
+      volatile int _readers;
+      char _pad[CACHE_LINE];
+
+    public:
+
+      ReaderStripe() : _readers(0) { }
+
+      //! Count a reader in, unless a writer has announced itself
+      inline bool arrive(volatile int& writer) {
+
+        __sync_add_and_fetch(&_readers, 1);
+
+#if defined(__ATOMIC_ACQUIRE)
+        if(__atomic_load_n(&writer, __ATOMIC_ACQUIRE) == 0)
+          return true;
+#else
+        int w = writer;
+        __sync_synchronize();
+
+        if(w == 0)
+          return true;
+#endif
+
+        __sync_sub_and_fetch(&_readers, 1);
+        return false;
+
+      }
+
+      //! Count a reader out, returning true if a writer is waiting to drain
+      inline bool depart(volatile int& writer) {
+
+        __sync_sub_and_fetch(&_readers, 1);
+        return writer != 0;
+
+      }
+
+      //! Number of readers counted in
+      inline int readers() {
+        return _readers;
+      }
+
+    };
+
+#else
+
+    inline void announce(volatile int& flag) {
+      flag = 1;
+    }
+
+    inline void retire(volatile int& flag) {
+      flag = 0;
+    }
+
+    inline void fence() { }
+
+    /**
+     * @class ReaderStripe
+     *
+     * Counts the readers that hash to it under a FastLock of its own. The writer
+     * flag is tested under the same lock, which orders it with the count.
+     */
+    class ReaderStripe {
+
+      FastLock _lock;
+      volatile int _readers;
+      char _pad[CACHE_LINE];
+
+    public:
+
+      ReaderStripe() : _readers(0) { }
+
+      //! Count a reader in, unless a writer has announced itself
+      inline bool arrive(volatile int& writer) {
+
+        Guard<FastLock> g(_lock);
+
+        if(writer != 0)
+          return false;
+
+        ++_readers;
+        return true;
+
+      }
+
+      //! Count a reader out, returning true if a writer is waiting to drain
+      inline bool depart(volatile int& writer) {
+
+        Guard<FastLock> g(_lock);
+
+        --_readers;
+        return writer != 0;
+
+      }
+
+      //! Number of readers counted in
+      inline int readers() {
+
+        Guard<FastLock> g(_lock);
+        return _readers;
+
+      }
+
+    };
+
+#endif
+
+  } // namespace
+
+  /**
+   * @class StripedReadWriteLockImpl
+   * @version 2.3.3
+   *
+   * Readers count themselves in on the stripe their thread hashes to, and only 
+   * touch the shared lock when a writer has announced itself. A writer takes 
+   * the write lock, which orders it with other writers, sets the writer flag and
+   * waits on the shared lock for the stripes to drain.
+   */
+  class StripedReadWriteLockImpl {
+
+    //! @class ReadLock
+    class ReadLock : public Lockable {
+
+      StripedReadWriteLockImpl& _impl;
+
+    public:
+
+      ReadLock(StripedReadWriteLockImpl& impl) : _impl(impl) {}
+
+      virtual ~ReadLock() {}
+
+      virtual void acquire() {
+        _impl.beforeRead();
+      }
+
+      virtual bool tryAcquire(unsigned long timeout) {            
+        return _impl.beforeReadAttempt(timeout);
+      }
+
+      virtual bool tryAcquire(const Deadline& deadline) {            
+        return _impl.beforeReadAttempt(deadline);
+      }
+
+      virtual void release() {
+        _impl.afterRead();
+      }
+
+    };
+
+    //! @class WriteLock
+    class WriteLock : public Lockable {
+
+      StripedReadWriteLockImpl& _impl;
+
+    public:
+
+      WriteLock(StripedReadWriteLockImpl& impl) : _impl(impl) {}
+
+      virtual ~WriteLock() {}
+
+      virtual void acquire() {
+        _impl.beforeWrite();
+      }
+
+      virtual bool tryAcquire(unsigned long timeout) {            
+        return _impl.beforeWriteAttempt(timeout);
+      }
+
+      virtual bool tryAcquire(const Deadline& deadline) {            
+        return _impl.beforeWriteAttempt(deadline);
+      }
+
+      virtual void release() {
+        _impl.afterWrite();
+      }
+
+    };
+
+    friend class ReadLock;
+    friend class WriteLock;
+
+    ReaderStripe* _stripes;
+    unsigned int _mask;
+
+    //! Set while a writer holds, or is waiting for, read-write access
+    volatile int _writer;
+
+    //! Serializes the writers
+    Mutex _writeLock;
+
+    //! Guards the blocking of readers and the draining of the stripes
+    FastMutex _lock;
+    Condition _readable;
+    Condition _drained;
+
+    ReadLock _rlock;
+    WriteLock _wlock;
+
+  public:
+
+    StripedReadWriteLockImpl(unsigned int stripes) 
+      : _stripes(new ReaderStripe[stripes]), _mask(stripes - 1), _writer(0), 
+        _readable(_lock), _drained(_lock), _rlock(*this), _wlock(*this) { }
+
+    ~StripedReadWriteLockImpl() {
+      delete[] _stripes;
+    }
+
+    Lockable& getReadLock() { return _rlock; }
+
+    Lockable& getWriteLock() { return _wlock; }
+
+  private:
+
+    //! Get the stripe the calling thread counts itself in on
+    ReaderStripe& stripe() {
+
+      size_t h = reinterpret_cast<size_t>(ThreadImpl::current());
+      h = (h >> 4) * 2654435761UL;
+
+      return _stripes[(h >> 16) & _mask];
+
+    }
+
+    //! Number of readers counted in on all the stripes
+    int readers() {
+
+      int n = 0;
+      for(unsigned int i = 0; i <= _mask; ++i)
+        n += _stripes[i].readers();
+
+      return n;
+
+    }
+
+    void beforeRead() {
+
+      ReaderStripe& s = stripe();
+
+      while(!s.arrive(_writer)) {
+
+        Guard<FastMutex> g(_lock);
+
+        // The writer may have counted this reader before it backed off
+        _drained.signal();
+
+        while(_writer != 0)
+          _readable.wait();
+
+      }
+
+    }
+
+    template <class Timeout>
+    bool beforeReadAttempt(const Timeout& timeout) {
+
+      ReaderStripe& s = stripe();
+
+      while(!s.arrive(_writer)) {
+
+        Guard<FastMutex> g(_lock);
+
+        // The writer may have counted this reader before it backed off
+        _drained.signal();
+
+        while(_writer != 0)
+          if(!_readable.wait(timeout))
+            return false;
+
+      }
+
+      return true;
+
+    }
+
+    void afterRead() {
+
+      if(stripe().depart(_writer)) {
+
+        Guard<FastMutex> g(_lock);
+        _drained.signal();
+
+      }
+
+    }
+
+    void beforeWrite() {
+
+      _writeLock.acquire();
+      announce(_writer);
+
+      try {
+
+        Guard<FastMutex> g(_lock);
+
+        while(readers() != 0)
+          _drained.wait();
+
+      } catch(...) {
+
+        afterWrite();
+        throw;
+
+      }
+
+      fence();
+
+    }
+
+    template <class Timeout>
+    bool beforeWriteAttempt(const Timeout& timeout) {
+
+      if(!_writeLock.tryAcquire(timeout))
+        return false;
+
+      announce(_writer);
+
+      bool result = true;
+
+      try {
+
+        Guard<FastMutex> g(_lock);
+
+        while(result && readers() != 0)
+          result = _drained.wait(timeout);
+
+      } catch(...) {
+
+        afterWrite();
+        throw;
+
+      }
+
+      // Let the readers back in if the stripes did not drain in time
+      if(!result) {
+
+        afterWrite();
+        return false;
+
+      }
+
+      fence();
+      return true;
+
+    }
+
+    void afterWrite() {
+
+      {
+
+        Guard<FastMutex> g(_lock);
+
+        retire(_writer);
+        _readable.broadcast();
+
+      }
+
+      _writeLock.release();
+
+    }
+
+  };
+
+  StripedReadWriteLock::StripedReadWriteLock() {
+
+    unsigned int n = processors() * 2;
+
+    if(n < MIN_STRIPES)
+      n = MIN_STRIPES;
+
+    else if(n > MAX_STRIPES)
+      n = MAX_STRIPES;
+
+    _impl = new StripedReadWriteLockImpl(roundUp(n));
+
+  }
+
+  StripedReadWriteLock::StripedReadWriteLock(unsigned int stripes) {
+
+    _impl = new StripedReadWriteLockImpl(roundUp(stripes));
+
+  }
+
+  StripedReadWriteLock::~StripedReadWriteLock() {
+
+    if(_impl != 0)
+      delete _impl;
+
+  }
+
+  Lockable& StripedReadWriteLock::getReadLock() {
+
+    return _impl->getReadLock();
+
+  }
+
+  Lockable& StripedReadWriteLock::getWriteLock() {
+
+    return _impl->getWriteLock();
+
+  }
+
+} // namespace ZThread
@@ -33,6 +33,10 @@ namespace ZThread {
 
   TSS<ThreadImpl*> ThreadImpl::_threadMap;
 
+#if defined(ZT_THREAD_LOCAL)
+  ZT_THREAD_LOCAL ThreadImpl* ThreadImpl::_current = 0;
+#endif
+
   namespace {
   
     class Launcher : public Runnable {
@@ -54,14 +58,16 @@ namespace ZThread {
   }
 
   ThreadImpl::ThreadImpl() 
-    : _state(State::REFERENCE), _priority(Medium), _autoCancel(false) {
+    : _state(State::REFERENCE), _priority(Medium), _autoCancel(false),
+      _nextWaiter(0), _prevWaiter(0), _waitList(0), _signalable(false), _requeued(false) {
     
     ZTDEBUG("Reference thread created.\n");
     
   }
 
   ThreadImpl::ThreadImpl(const Task& task, bool autoCancel) 
-    : _state(State::IDLE), _priority(Medium), _autoCancel(autoCancel) {
+    : _state(State::IDLE), _priority(Medium), _autoCancel(autoCancel),
+      _nextWaiter(0), _prevWaiter(0), _waitList(0), _signalable(false), _requeued(false) {
     
     ZTDEBUG("User thread created.\n");
 
@@ -233,12 +239,13 @@ namespace ZThread {
   /**
    * Get a reference to an implmenetation that maps to the current thread.
    * Accomplished by checking the TLS map. This will always return a valid
-   * ThreadImpl instance.
+   * ThreadImpl instance. current() only needs to call this when there is no
+   * ThreadImpl cached in the compiler's thread local storage.
    *
    * @return ThreadImpl* current implementation that maps to the
    * executing thread.
    */ 
-  ThreadImpl* ThreadImpl::current() {
+  ThreadImpl* ThreadImpl::discover() {
     
     // Get the ThreadImpl previously mapped onto the executing thread.
     ThreadImpl* impl = _threadMap.get();
@@ -255,6 +262,10 @@ namespace ZThread {
       
       // Map a reference thread and insert it into the queue
       _threadMap.set(impl);
+
+#if defined(ZT_THREAD_LOCAL)
+      _current = impl;
+#endif
       
       ThreadQueue::instance()->insertReferenceThread(impl);
       
@@ -265,6 +276,49 @@ namespace ZThread {
     
   }
   
+  /**
+   * Create a reference thread for a task that an already running thread will
+   * run next, so that the task does not share its identity with the tasks that
+   * thread ran before. It holds the ThreadLocal values and the priority a thread
+   * started by the given parent would have.
+   *
+   * @param parent thread handing the task over
+   *
+   * @return ThreadImpl* new reference thread, to be bind()ed by the thread that 
+   *         runs the task
+   */
+  ThreadImpl* ThreadImpl::createReference(ThreadImpl* parent) {
+
+    ThreadImpl* impl = new ThreadImpl();
+    impl->_state.setReference();
+
+    impl->inheritThreadLocals(parent);
+    impl->_priority = parent->_state.isReference() ? Medium : parent->_priority;
+
+    return impl;
+
+  }
+
+  /**
+   * Map a ThreadImpl onto the executing thread, current() returns it from 
+   * then on. A reference thread made by createReference() is activated the 
+   * first time it is bound.
+   *
+   * @param impl ThreadImpl to map
+   */
+  void ThreadImpl::bind(ThreadImpl* impl) {
+
+    if(impl->_state.isReference() && !ThreadOps::isCurrent(impl))
+      ThreadOps::activate(impl);
+
+    _threadMap.set(impl);
+
+#if defined(ZT_THREAD_LOCAL)
+    _current = impl;
+#endif
+
+  }
+
   /**
    * Make current thread sleep for the given number of milliseconds.
    * This sleep can be interrupt()ed.
@@ -331,6 +385,40 @@ namespace ZThread {
     
   }
 
+  /**
+   * Replace the ThreadLocal values of this thread with copies of the inheritable
+   * values held by the given thread. This thread must not be running a task
+   * while its values are replaced.
+   *
+   * @param parent thread to inherit values from
+   */
+  void ThreadImpl::inheritThreadLocals(ThreadImpl* parent) {
+
+    const ThreadLocalMap& values = parent->getThreadLocalMap();
+
+    _tls.clear();
+    _tls.resize(values.size());
+
+    for(size_t i = 0; i < values.size(); ++i) 
+      if( values[i].serial != 0 && values[i].value->isInheritable() ) {
+        _tls[i].value = values[i].value->clone();
+        _tls[i].serial = values[i].serial;
+      }
+
+  }
+
+  /**
+   * Give this thread the priority a thread started by the given thread would 
+   * have. Used when a thread that has already run a task is handed another.
+   *
+   * @param parent thread to inherit the priority from
+   */
+  void ThreadImpl::inheritPriority(ThreadImpl* parent) {
+
+    setPriority(parent->_state.isReference() ? Medium : parent->_priority);
+
+  }
+
   void ThreadImpl::start(const Task& task) {
 
     Guard<Monitor> g1(_monitor);
@@ -348,11 +436,7 @@ namespace ZThread {
     Launcher* launcher = new Launcher(this, task);
 
     // Inherit ThreadLocal values from the parent
-    typedef ThreadLocalMap::const_iterator It;
-
-    for(It i = parent->getThreadLocalMap().begin(); i != parent->getThreadLocalMap().end(); ++i) 
-      if( (i->second)->isInheritable() )
-        getThreadLocalMap()[ i->first ] = (i->second)->clone();
+    inheritThreadLocals(parent);
 
     if(!spawn(launcher)) {
 
@@ -385,6 +469,10 @@ namespace ZThread {
 
     // Map the implementation object onto the running thread.
     _threadMap.set(this);
+
+#if defined(ZT_THREAD_LOCAL)
+    _current = this;
+#endif
     
 
 /*
@@ -33,8 +33,15 @@
 #include "ThreadOps.h"
 #include "State.h"
 
-#include <map>
 #include <deque>
+#include <vector>
+
+// Cache the ThreadImpl for the executing thread in storage the compiler provides 
+// for each thread, rather than looking it up with the TSS on every call to current()
+#if !defined(ZTHREAD_DISABLE_TLS) && defined(ZT_POSIX) && !defined(__APPLE__) && \
+    defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 3))
+#  define ZT_THREAD_LOCAL __thread
+#endif
 
 namespace ZThread {
 
@@ -51,6 +58,13 @@ class ThreadImpl : public IntrusivePtr<ThreadImpl, FastLock>, public ThreadOps {
   //! TSS to store implementation to current thread mapping.
   static TSS<ThreadImpl*> _threadMap;
 
+#if defined(ZT_THREAD_LOCAL)
+
+  //! Copy of the _threadMap entry for the executing thread
+  static ZT_THREAD_LOCAL ThreadImpl* _current;
+
+#endif
+
   //! The Monitor for controlling this thread
   Monitor _monitor;
   
@@ -62,7 +76,20 @@ class ThreadImpl : public IntrusivePtr<ThreadImpl, FastLock>, public ThreadOps {
 
  public:
   
-  typedef std::map<const ThreadLocalImpl*, ThreadLocalImpl::ValuePtr > ThreadLocalMap;
+  //! The value of one ThreadLocal for this thread
+  struct ThreadLocalSlot {
+
+    ThreadLocalImpl::ValuePtr value;
+
+    //! Serial number of the ThreadLocal that owns the value, 0 if empty
+    size_t serial;
+
+    ThreadLocalSlot() : serial(0) { }
+
+  };
+
+  //! Values for each ThreadLocal, indexed by the ThreadLocal
+  typedef std::vector<ThreadLocalSlot> ThreadLocalMap;
 
  private:
   
@@ -73,6 +100,28 @@ class ThreadImpl : public IntrusivePtr<ThreadImpl, FastLock>, public ThreadOps {
 
   //! Request cancel() when main() goes out of scope
   bool _autoCancel;
+
+  //! Intrusive links for the fifo_list this thread is waiting in
+  ThreadImpl* _nextWaiter;
+  ThreadImpl* _prevWaiter;
+
+  //! The fifo_list this thread is waiting in, if any
+  const void* _waitList;
+
+  //! Set while this thread waits on a MutexImpl, ConditionImpl, SemaphoreImpl 
+  //! or FutureImpl and can still accept a signal, guarded by the Monitor
+  bool _signalable;
+
+  //! Set once a ConditionImpl has moved this thread onto its predicate lock, 
+  //! guarded by the Monitor
+  bool _requeued;
+
+  friend class fifo_list;
+
+  template <typename List, typename Behavior> friend class MutexImpl;
+  template <typename List> friend class ConditionImpl;
+  template <typename List> friend class SemaphoreImpl;
+  friend class FutureImpl;
   
   void start(const Task& task);
 
@@ -99,6 +148,10 @@ class ThreadImpl : public IntrusivePtr<ThreadImpl, FastLock>, public ThreadOps {
   //  ThreadLocalMap& getThreadLocalMap();
   ThreadLocalMap& getThreadLocalMap() { return _tls; }
 
+  void inheritThreadLocals(ThreadImpl* parent);
+
+  void inheritPriority(ThreadImpl* parent);
+
   bool join(unsigned long); 
   
   void setPriority(Priority);
@@ -111,7 +164,28 @@ class ThreadImpl : public IntrusivePtr<ThreadImpl, FastLock>, public ThreadOps {
 
   static void yield();
   
-  static ThreadImpl* current();
+#if defined(ZT_THREAD_LOCAL)
+
+  static ThreadImpl* current() {
+
+    ThreadImpl* impl = _current;
+    return impl ? impl : discover();
+
+  }
+
+#else
+
+  static ThreadImpl* current() {
+    return discover();
+  }
+
+#endif
+
+  static ThreadImpl* discover();
+
+  static ThreadImpl* createReference(ThreadImpl* parent);
+
+  static void bind(ThreadImpl* impl);
 
   void dispatch(Task);
 
@@ -21,13 +21,86 @@
  */
 
 #include "zthread/ThreadLocalImpl.h"
+#include "zthread/Guard.h"
 #include "ThreadImpl.h"
+#include "FastLock.h"
+
+#include <vector>
 
 namespace ZThread {
 
-  ThreadLocalImpl::ThreadLocalImpl() {}
+  namespace {
+
+    /**
+     * Hands out the slot index and serial number for each ThreadLocalImpl. 
+     * ThreadLocals with static storage may be destroyed after any other static
+     * object, so the registry is created on first use and never destroyed.
+     */
+    class SlotRegistry {
+
+      FastLock _lock;
+
+      //! Indices released by destroyed ThreadLocals
+      std::vector<size_t> _free;
+
+      //! Next index that has never been used
+      size_t _next;
+
+      //! Last serial number handed out
+      size_t _serial;
+
+      SlotRegistry() : _next(0), _serial(0) { }
+
+    public:
+
+      static SlotRegistry& instance() {
+
+        static SlotRegistry* registry = new SlotRegistry;
+        return *registry;
+
+      }
+
+      void acquire(size_t& index, size_t& serial) {
+
+        Guard<FastLock> g(_lock);
+
+        if(_free.empty())
+          index = _next++;
+
+        else {
+
+          index = _free.back();
+          _free.pop_back();
+
+        }
+
+        // Serial numbers start at 1, an empty slot has a serial of 0
+        serial = ++_serial;
 
-  ThreadLocalImpl::~ThreadLocalImpl() {} 
+      }
+
+      void release(size_t index) {
+
+        Guard<FastLock> g(_lock);
+        _free.push_back(index);
+
+      }
+
+    };
+
+  } // namespace
+
+  ThreadLocalImpl::ThreadLocalImpl() {
+    SlotRegistry::instance().acquire(_index, _serial);
+  }
+
+  ThreadLocalImpl::~ThreadLocalImpl() {
+
+    // Values left in other threads are recognized as stale by their serial
+    // number, and released when the slot is reused or the thread exits
+    SlotRegistry::instance().release(_index);
+
+  } 
   
   void ThreadLocalImpl::clearAll() {
 
@@ -43,23 +116,34 @@ namespace ZThread {
     typedef ThreadImpl::ThreadLocalMap Map;
     Map& m = ThreadImpl::current()->getThreadLocalMap();
     
-    Map::iterator i = m.find(this);
-    if(i != m.end()) 
-      m.erase(i);
+    if(_index < m.size() && m[_index].serial == _serial) {
+
+      m[_index].value.reset();
+      m[_index].serial = 0;
+
+    }
 
   } 
 
-  ThreadLocalImpl::ValuePtr ThreadLocalImpl::value( ValuePtr(*pfn)() ) const {
+  ThreadLocalImpl::Value* ThreadLocalImpl::value( ValuePtr(*pfn)() ) const {
      
     typedef ThreadImpl::ThreadLocalMap Map;
     Map& m = ThreadImpl::current()->getThreadLocalMap();
     
-    Map::iterator i = m.find(this);
-    if(i != m.end()) 
-      return i->second;
-    
-    m[ this ] = ValuePtr( pfn() );
-    return m[ this ];
+    if(_index < m.size() && m[_index].serial == _serial) 
+      return &*m[_index].value;
+
+    // Create the value before touching the slots, the initial value
+    // function is free to use other ThreadLocals
+    ValuePtr v( pfn() );
+
+    if(_index >= m.size())
+      m.resize(_index + 1);
+
+    m[_index].value = v;
+    m[_index].serial = _serial;
+
+    return &*m[_index].value;
 
   }
 
@@ -143,7 +143,7 @@ namespace ZThread {
       if(_waiter && _waiter != (ThreadImpl*)1)
         _waiter->getMonitor().notify();
       else
-        _waiter = (ThreadImpl*)!_waiter;
+        _waiter = (ThreadImpl*)1;
 
     ZTDEBUG("1 pending-thread added.\n");
 
@@ -166,8 +166,12 @@ namespace ZThread {
     // Reclaim pending-threads
     pollPendingThreads();
 
+    // A pending-thread no longer means every user-thread is done
+    if(_waiter == (ThreadImpl*)1)
+      _waiter = 0;
+
     // Auto-cancel threads that are started when main() is out of scope
-    if(_waiter)
+    else if(_waiter)
       impl->cancel(true);
 
     ZTDEBUG("1 user-thread added.\n");
@@ -232,8 +236,9 @@ namespace ZThread {
 
       Guard<FastLock> g(_lock);
     
-      // Execute later when the ThreadQueue is destroyed  
-      if( !(hasWaiter = (_waiter != 0)) ) {
+      // Execute later when the ThreadQueue is destroyed. A _waiter of 1 only
+      // notes that no user-threads are running, main() has not gone out of scope
+      if( !(hasWaiter = (_waiter != 0 && _waiter != (ThreadImpl*)1)) ) {
 
         _shutdownTasks.push_back(task);
         //ZTDEBUG("1 shutdown task added. %d\n", _shutdownTasks.size());
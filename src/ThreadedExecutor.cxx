@@ -21,6 +21,7 @@
  */
 
 #include "zthread/ThreadedExecutor.h"
+#include "zthread/Condition.h"
 #include "zthread/Guard.h"
 #include "zthread/FastMutex.h"
 #include "zthread/Time.h"
@@ -45,22 +46,11 @@ namespace ZThread {
              // "ThreadedExecutor.cxx", line 76: error: type "ZThread::<unnamed>::WaiterQueue::Group" is inaccessible
     #endif
 
-      typedef std::deque<ThreadImpl*>  ThreadList;
-      
       typedef struct group_t {
         size_t     id;
         size_t     count;
-        ThreadList waiters;
-        group_t(size_t n) : id(n), count(0) {}
-        
-        // A. Scheurer
-        // I created this copy constructor because w/o the ThreadedExecutor creates threads which suspend/hang.
-        // This copy constructor is needed for insertion of these objects into _list or std::deque
-        // The compiler supplied copy constructor was causing process to core, 
-        // ThreadList was probably being copied when it shouldn't have, since the List is that of 
-        // ThreadImpl's - having it in 2 containers could cause double deletion.
-        // push_back or insert into the std::deque causes a group object to be copied via this constructor.
-        group_t(const group_t& rhs) { id = rhs.id; count = rhs.count; /* waiters = rhs.waiters; ?? */ }
+        size_t     waiters;
+        group_t(size_t n) : id(n), count(0), waiters(0) {}
       } Group;
 
       typedef std::deque<Group>  GroupList;
@@ -83,13 +73,17 @@ namespace ZThread {
       };
       
       FastMutex     _lock;
+
+      //! Broadcast when the first group completes
+      Condition _completed;
+
       GroupList _list;
       size_t    _id;
       size_t    _generation;
 
     public:
       
-      WaiterQueue() : _id(0), _generation(0) {
+      WaiterQueue() : _completed(_lock), _id(0), _generation(0) {
         // At least one empty-group exists
         _list.push_back(Group(_id++));
       }
@@ -102,12 +96,7 @@ namespace ZThread {
        */
       bool wait(unsigned long timeout) {
 
-        ThreadImpl* self = ThreadImpl::current();
-        Monitor& m = self->getMonitor();
-
-        Monitor::STATE state;
-
-        Guard<Lockable> g1(_lock);
+        Guard<FastMutex> g1(_lock);
 
         // At least one empty-group exists
         assert(!_list.empty());
@@ -116,48 +105,37 @@ namespace ZThread {
         if((size_t)std::for_each(_list.begin(), _list.end(), counter()) < 1)
           return true;
 
-        // Update the waiter list for the active group 
-        _list.back().waiters.push_back(self);
+        // Wait in the active group until every task in it has completed
+        _list.back().waiters++;
         size_t n = _list.back().id;
 
-        m.acquire();
-        
-        {
-          
-          Guard<Lockable, UnlockedScope> g2(g1);          
-          state = timeout == 0 ? m.wait() : m.wait(timeout);
+        bool completed = false;
 
-        }
+        try {
 
-        m.release();
+          while(!(completed = std::find_if(_list.begin(), _list.end(), by_id(n)) == _list.end())) {
 
-        // If awoke due to a reason other than the last task in the group 'n' completing,
-        // then then find the group 'self' is waiting in
-        GroupList::iterator i = std::find_if(_list.begin(), _list.end(), by_id(n));
-        if(i != _list.end()) {
+            if(timeout == 0)
+              _completed.wait();
+            else if(!_completed.wait(timeout))
+              break;
+
+          }
 
-          // Remove 'self' from that list if it is still a member
-          ThreadList::iterator j = std::find(i->waiters.begin(), i->waiters.end(), self);
-          if(j != i->waiters.end())
-            i->waiters.erase(j);
+        } catch(...) { 
+
+          leave(n);
+          throw;
 
         }
 
+        if(!completed)
+          leave(n);
+
         // At least one empty-group exists
         assert(!_list.empty());
 
-        switch(state) {
-          case Monitor::SIGNALED:
-            break;
-          case Monitor::TIMEDOUT:
-            return false;
-          case Monitor::INTERRUPTED:
-            throw Interrupted_Exception();
-          default:
-            throw Synchronization_Exception();
-        } 
-       
-        return true;
+        return completed;
 
       }
       
@@ -189,7 +167,7 @@ namespace ZThread {
 
         // When the active group is being incremented, insert a new active group
         // to replace it if there were waiting threads
-        if(i == --_list.end() && !i->waiters.empty()) 
+        if(i == --_list.end() && i->waiters > 0) 
           _list.push_back(Group(_id++));
 
         // At least 1 non-empty group exists
@@ -228,37 +206,15 @@ namespace ZThread {
         // Decrease the count for tasks in this group,
         if(--i->count == 0 && i == _list.begin()) {
           
+          // When the first group completes, wake all waiters for every
+          // group, starting from the first until a group that is not 
+          // complete is reached
           do { 
 
-            // When the first group completes, wake all waiters for every
-            // group, starting from the first until a group that is not 
-            // complete is reached
-
-            /*
-            // Don't remove the empty active group
-            if(i == --_list.end() && i->waiters.empty())
-              break;
-            */
-            
-            if( awaken(*i) ) {
-            
-              // If all waiters were awakened, remove the group  
-              i = _list.erase(i);
-              
-            } else {
-              
-              {
+            if(i->waiters > 0)
+              _completed.broadcast();
 
-                // Otherwise, unlock and yield allowing the waiter
-                // lists to be updated if other threads are busy
-                Guard<FastLock, UnlockedScope> g2(g1);
-                ThreadImpl::yield();
-              
-              }
-
-              i = _list.begin();
-
-            }
+            i = _list.erase(i);
               
           } while(i != _list.end() && i->count == 0); 
           
@@ -291,47 +247,24 @@ namespace ZThread {
       
     private:
       
-      /**
-       * Awaken all the waiters remaining in the given group
-       * 
-       * @return
-       *   - true if all the waiting threads were successfully awakened.
-       *   - false if there were one or more threads that could not be awakened.
-       */
-      bool awaken(Group& grp) {
+      //! Stop waiting on a group that has not completed
+      void leave(size_t n) {
 
-        // Go through the waiter list in the given group; 
-        for(ThreadList::iterator i = grp.waiters.begin(); i != grp.waiters.end();) {
-          
-          ThreadImpl* impl = *i;
-          Monitor& m = impl->getMonitor();
-          
-          // Try the monitor lock, if it cant be locked skip to the next waiter
-          if(m.tryAcquire()) {
-            
-            // Notify the monitor & remove from the waiter list so time isn't
-            // wasted checking it again.
-            i = grp.waiters.erase(i);
-            
-            // Try to wake the waiter, it doesn't matter if this is successful
-            // or not (only fails when the monitor is already going to stop waiting). 
-            m.notify();
-            m.release();
-            
-          } else ++i;
-          
-        }
-        
-        return grp.waiters.empty();
+        GroupList::iterator i = std::find_if(_list.begin(), _list.end(), by_id(n));
+        if(i != _list.end())
+          i->waiters--;
 
       }
 
     };
 
+    class Worker;
+
     //! Synchronization point for the Executor 
     class ExecutorImpl {
 
       typedef std::deque<ThreadImpl*> ThreadList;
+      typedef std::deque<Worker*> WorkerList;
 
       bool _canceled;
       FastMutex _lock;      
@@ -341,14 +274,24 @@ namespace ZThread {
       
       WaiterQueue _queue;
 
+      //! Time (ms) a thread waits for another task before exiting, 0 disables caching
+      unsigned long _keepAlive;
+
+      //! Idle threads, most recently idle last
+      WorkerList _idle;
+
     public:
 
-      ExecutorImpl() : _canceled(false) {}
+      ExecutorImpl(unsigned long keepAlive) : _canceled(false), _keepAlive(keepAlive) {}
 
       WaiterQueue& getWaiterQueue() { 
         return _queue;
       }
 
+      FastMutex& getLock() {
+        return _lock;
+      }
+
       void registerThread(size_t generation) {
                
         // Interrupt slow starting threads
@@ -368,7 +311,7 @@ namespace ZThread {
       void unregisterThread() {
         
         Guard<FastMutex> g(_lock);
-        std::remove(_threads.begin(), _threads.end(), ThreadImpl::current() );
+        _threads.erase(std::remove(_threads.begin(), _threads.end(), ThreadImpl::current()), _threads.end());
 
       }
 
@@ -377,6 +320,8 @@ namespace ZThread {
         Guard<FastMutex> g(_lock);
         _canceled = true;
 
+        releaseIdle();
+
       }
 
       bool isCanceled() {
@@ -402,6 +347,24 @@ namespace ZThread {
 
       }      
 
+      //! Stop caching threads, letting any idle threads exit
+      void shutdown() {
+
+        Guard<FastMutex> g(_lock);
+        _keepAlive = 0;
+
+        releaseIdle();
+
+      }
+
+      bool dispatch(const Task& task);
+
+      bool park(Worker* w);
+
+    private:
+
+      void releaseIdle();
+
     }; /* ExecutorImpl */
 
     //! Wrap a generation and a group around a task
@@ -413,13 +376,33 @@ namespace ZThread {
       size_t _generation;
       size_t _group;
 
+      //! Thread running this Worker, set once it is idle
+      ThreadImpl* _thread;
+
+      //! Identity for the task handed to this Worker while it was idle
+      ThreadImpl* _identity;
+
+      //! Signaled when an idle Worker is given a task or released
+      Condition _wakeup;
+
+      //! Set when an idle Worker is given a task
+      bool _assigned;
+
     public:
 
       Worker(const CountedPtr< ExecutorImpl >& impl, const Task& task)
-        : _impl(impl), _task(task) {
+        : _impl(impl), _task(task), _thread(0), _identity(0), _wakeup(_impl->getLock()), _assigned(false) {
+
+        assign(task);
+
+      }
+
+      //! Set the task to run next, and the group it is counted in
+      void assign(const Task& task) {
 
         std::pair<size_t, size_t> pr( _impl->getWaiterQueue().increment() );
     
+        _task       = task;
         _group      = pr.first;
         _generation = pr.second;
 
@@ -432,37 +415,173 @@ namespace ZThread {
       size_t generation() const {
         return _generation;
       }
+
+      /**
+       * Hand a task to this idle Worker. The executor lock must be held.
+       */
+      void resume(const Task& task) {
+
+        assign(task);
+
+        // Run the task as a thread of its own, with the ThreadLocal values 
+        // and the priority a new thread would have
+        ThreadImpl* parent = ThreadImpl::current();
+
+        _identity = ThreadImpl::createReference(parent);
+        _thread->inheritPriority(parent);
+
+        _assigned = true;
+        _wakeup.signal();
+
+      }
+
+      /**
+       * Wait for a task to be handed to this Worker. The executor lock must be held.
+       *
+       * @return bool true if a task was handed to this Worker
+       */
+      bool idle(unsigned long keepAlive) {
+
+        _thread = ThreadImpl::current();
+        _assigned = false;
+
+        try {
+          _wakeup.wait(keepAlive);
+        } catch(Synchronization_Exception&) {
+          /* exit once no task could have been assigned */
+        }
+
+        return _assigned;
+
+      }
+
+      //! Wake this idle Worker without a task. The executor lock must be held.
+      void release() {
+        _wakeup.signal();
+      }
       
       void run() {
+
+        do {
+
+          // A task handed over while this thread was idle gets an identity 
+          // of its own, so it does not share one with the tasks run before it
+          if(_identity)
+            ThreadImpl::bind(_identity);
         
-        // Register this thread once its begun; the generation is used to ensure
-        // threads that are slow starting are properly interrupted
+          // Register this thread once its begun; the generation is used to ensure
+          // threads that are slow starting are properly interrupted
 
-        _impl->registerThread( generation() );
+          _impl->registerThread( generation() );
         
-        try {
-          _task->run();          
-        } catch(...) {
-          /* consume the exceptions the work propogates */
-        }
+          try {
+            _task->run();          
+          } catch(...) {
+            /* consume the exceptions the work propogates */
+          }
         
-        _impl->getWaiterQueue().decrement( group() );
+          _impl->getWaiterQueue().decrement( group() );
+
+          // Unregister this thread
+
+          _impl->unregisterThread();
 
-        // Unregister this thread
+          _task.reset();
 
-        _impl->unregisterThread();
+          if(_identity) {
+
+            ThreadImpl::bind(_thread);
+
+            _identity->delReference();
+            _identity = 0;
+
+          }
+
+          // Wait for another task, if threads are being cached
+        } while(_impl->park(this));
 
       }
 
     }; /* Worker */
 
+    /**
+     * Hand a task to an idle thread.
+     *
+     * @return bool false if there were no idle threads
+     */
+    bool ExecutorImpl::dispatch(const Task& task) {
+
+      Guard<FastMutex> g(_lock);
+
+      if(_idle.empty())
+        return false;
+
+      Worker* w = _idle.back();
+      _idle.pop_back();
+
+      w->resume(task);
+      return true;
+
+    }
+
+    /**
+     * Keep the thread running the given Worker in the idle list until a task is 
+     * handed to it, or until the keep alive time expires.
+     *
+     * @return bool true if a task was handed to the Worker
+     */
+    bool ExecutorImpl::park(Worker* w) {
+
+      // Give the thread the clean slate a new thread would have: no 
+      // ThreadLocal values and no interrupted status
+      ThreadImpl* self = ThreadImpl::current();
+
+      self->getThreadLocalMap().clear();
+      self->isInterrupted();
+
+      Guard<FastMutex> g(_lock);
+
+      if(_keepAlive == 0 || _canceled)
+        return false;
+
+      _idle.push_back(w);
+
+      if(w->idle(_keepAlive))
+        return true;
+
+      // Timed out, or released by releaseIdle()
+      WorkerList::iterator i = std::find(_idle.begin(), _idle.end(), w);
+      if(i != _idle.end())
+        _idle.erase(i);
+
+      return false;
+
+    }
+
+    void ExecutorImpl::releaseIdle() {
+
+      for(WorkerList::iterator i = _idle.begin(); i != _idle.end(); ++i)
+        (*i)->release();
+
+      _idle.clear();
+
+    }
+
   }
 
-  ThreadedExecutor::ThreadedExecutor() : _impl(new ExecutorImpl) {}
+  ThreadedExecutor::ThreadedExecutor() : _impl(new ExecutorImpl(0)) {}
 
-  ThreadedExecutor::~ThreadedExecutor() {}
+  ThreadedExecutor::ThreadedExecutor(unsigned long keepAlive) : _impl(new ExecutorImpl(keepAlive)) {}
+
+  ThreadedExecutor::~ThreadedExecutor() {
+    _impl->shutdown();
+  }
   
   void ThreadedExecutor::execute(const Task& task) {
+
+    // Prefer a cached thread to starting a new one
+    if(_impl->dispatch(task))
+      return;
      
     Thread t( new Worker(_impl, task) );
 
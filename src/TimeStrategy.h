@@ -54,6 +54,24 @@
 
 #endif
 
+// Prefer the monotonic clock when the system provides it along with the
+// clock selection for condition variables, so that pthreads based waits 
+// can be timed against the same clock
+#if defined(ZT_POSIX) && !defined(ZTHREAD_DISABLE_MONOTONIC_CLOCK)
+
+#  include <unistd.h>
+
+#  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK >= 0) && \
+      defined(_POSIX_CLOCK_SELECTION) && (_POSIX_CLOCK_SELECTION >= 0)
+
+#    ifndef HAVE_CLOCK_MONOTONIC
+#    define HAVE_CLOCK_MONOTONIC
+#    endif
+
+#  endif
+
+#endif
+
 // Some systems require this to complete the definition of timespec
 // which is needed by pthreads.
 #if defined(HAVE_SYS_TYPES_H)
@@ -64,6 +82,10 @@
 
 #  include "macos/UpTimeStrategy.h"
 
+#elif defined(HAVE_CLOCK_MONOTONIC)
+
+#  include "posix/ClockGetTimeStrategy.h"
+
 #elif defined(HAVE_PERFORMANCECOUNTER)
               
 #  include "win32/PerformanceCounterStrategy.h"
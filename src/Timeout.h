@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTTIMEOUT_H__
+#define __ZTTIMEOUT_H__
+
+#include "zthread/Deadline.h"
+
+namespace ZThread {
+
+// The timed operations of the synchronization objects are written once, for
+// either kind of timeout: a number of milliseconds, measured from the start 
+// of the operation, or an absolute Deadline. Both are passed straight through 
+// to Monitor::wait().
+
+/**
+ * Test whether a timed operation should give up without waiting.
+ *
+ * @param timeout - number of milliseconds
+ * @return bool true if <i>timeout</i> is 0
+ */
+inline bool expired(unsigned long timeout) {
+  return timeout == 0;
+}
+
+/**
+ * Test whether a timed operation should give up without waiting.
+ *
+ * @param deadline - Deadline of the operation
+ * @return bool true if the <i>deadline</i> has passed
+ */
+inline bool expired(const Deadline& deadline) {
+  return deadline.expired();
+}
+
+} // namespace ZThread
+
+#endif // __ZTTIMEOUT_H__
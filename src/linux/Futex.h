@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTFUTEX_H__
+#define __ZTFUTEX_H__
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+// Older kernel headers do not define the process-private operations
+#if !defined(FUTEX_PRIVATE_FLAG)
+#  define FUTEX_PRIVATE_FLAG 0
+#endif
+
+namespace ZThread {
+
+/**
+ * @class Futex
+ * @version 2.3.3
+ *
+ * Thin wrapper around the linux futex system call, and the handful of
+ * gcc atomic builtins needed to manipulate a futex word. The futex is
+ * always used as a process-private object, it is never placed in 
+ * memory shared between processes.
+ */ 
+class Futex {
+public:
+
+  /**
+   * Block the calling thread for as long as the word at <i>addr</i>
+   * holds the value <i>val</i>. 
+   *
+   * @param addr futex word
+   * @param val expected value 
+   * @param timeout relative timeout, or 0 to block indefinitely
+   *
+   * @return 0 if awakened, otherwise the errno value (EAGAIN, EINTR or ETIMEDOUT)
+   */
+  static inline int wait(volatile int* addr, int val, const struct ::timespec* timeout = 0) {
+
+    if(::syscall(SYS_futex, addr, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, val, timeout, 0, 0) == 0)
+      return 0;
+
+    return errno;
+
+  }
+
+  /**
+   * Wake up to <i>n</i> threads blocked on the word at <i>addr</i>.
+   *
+   * @return number of threads awakened
+   */
+  static inline int wake(volatile int* addr, int n = 1) {
+    return (int)::syscall(SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, n, 0, 0, 0);
+  }
+
+  //! Compare and swap, returning the value that was found at <i>addr</i>
+  static inline int cas(volatile int* addr, int expected, int desired) {
+    return __sync_val_compare_and_swap(addr, expected, desired);
+  }
+
+  //! Exchange, returning the previous value (acquire barrier)
+  static inline int swap(volatile int* addr, int value) {
+    return __sync_lock_test_and_set(addr, value);
+  }
+
+  //! Atomic add, returning the previous value (full barrier)
+  static inline int add(volatile int* addr, int value) {
+    return __sync_fetch_and_add(addr, value);
+  }
+
+  //! Atomic or, returning the previous value (full barrier)
+  static inline int set(volatile int* addr, int bits) {
+    return __sync_fetch_and_or(addr, bits);
+  }
+
+  //! Atomic and-not, returning the previous value (full barrier)
+  static inline int unset(volatile int* addr, int bits) {
+    return __sync_fetch_and_and(addr, ~bits);
+  }
+
+  //! Hint to the processor that the caller is spinning
+  static inline void relax() {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__("pause" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+  }
+
+}; /* Futex */
+
+} // namespace ZThread
+
+#endif // __ZTFUTEX_H__
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTFASTLOCK_H__
+#define __ZTFASTLOCK_H__
+
+#include "zthread/NonCopyable.h"
+#include "Futex.h"
+#include <assert.h>
+
+namespace ZThread {
+
+/**
+ * @class FastLock
+ * @version 2.3.3
+ *
+ * This implementation of a FastLock is built directly on a linux futex. 
+ * The lock is a single word with three states: unlocked, locked and 
+ * locked with waiters. An uncontended acquire() or release() is one atomic 
+ * instruction and never enters the kernel. 
+ *
+ * A contended acquire() spins for a short, bounded time before parking 
+ * the thread in the kernel. The length of that spin adapts to how long 
+ * it has recently taken for the lock to become free, much like glibc's 
+ * adaptive mutexes.
+ */ 
+class FastLock : private NonCopyable {
+
+  enum { UNLOCKED = 0, LOCKED = 1, CONTENDED = 2 };
+
+  //! Upper bound on the adaptive spin
+  enum { MAX_SPINS = 100 };
+
+  //! Lock word
+  volatile int _value;
+
+  //! Running estimate of the spins needed to acquire the lock
+  volatile int _spins;
+
+public:
+  
+  inline FastLock() : _value(UNLOCKED), _spins(0) { }
+  
+  inline ~FastLock() {
+    assert(_value == UNLOCKED);
+  }
+  
+  inline void acquire() {
+
+    int c = Futex::cas(&_value, UNLOCKED, LOCKED);
+    if(c != UNLOCKED)
+      contend();
+
+  }
+
+  inline bool tryAcquire(unsigned long timeout=0) {
+    return Futex::cas(&_value, UNLOCKED, LOCKED) == UNLOCKED;
+  }
+
+  inline void release() {
+    
+    // Only enter the kernel if some thread may be parked 
+    if(Futex::add(&_value, -1) != LOCKED) {
+
+      _value = UNLOCKED;
+      Futex::wake(&_value, 1);
+
+    }
+
+  }
+
+private:
+
+  void contend() {
+
+    int limit = _spins * 2 + 10;
+    if(limit > MAX_SPINS)
+      limit = MAX_SPINS;
+
+    // Spin briefly, the owner is likely to release the lock soon
+    for(int n = 0; n < limit; ++n) {
+
+      Futex::relax();
+
+      if(_value == UNLOCKED && Futex::cas(&_value, UNLOCKED, LOCKED) == UNLOCKED) {
+
+        _spins += (n - _spins) / 8;
+        return;
+
+      }
+
+    }
+
+    _spins += (limit - _spins) / 8;
+
+    // Mark the lock contended and park until it is released. Once a thread 
+    // has parked the lock stays contended until it is released, so that 
+    // the next release() wakes any remaining waiters.
+    while(Futex::swap(&_value, CONTENDED) != UNLOCKED)
+      Futex::wait(&_value, CONTENDED);
+
+  }
+  
+}; /* FastLock */
+
+
+} // namespace ZThread
+
+#endif
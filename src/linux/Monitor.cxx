@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "Monitor.h"
+#include "../Debug.h"
+
+#include <errno.h>
+#include <assert.h>
+#include <time.h>
+
+namespace ZThread {
+
+Monitor::Monitor() : _state(INVALID), _owner(0) { }
+ 
+Monitor::~Monitor() {
+  
+  assert((_state & WAITING) == 0);
+  
+}
+
+Monitor::STATE Monitor::next() {
+
+  for(;;) {
+
+    int s = _state;
+    int n = s & ~WAITING;
+
+    STATE state = INVALID;
+    
+    if(pending(s, SIGNALED)) {
+
+      // Absorb the timeout if it happens when a signal
+      // is available at the same time
+      n &= ~(SIGNALED|TIMEDOUT);
+      state = SIGNALED;
+
+    } else if(pending(s, TIMEDOUT)) {
+
+      n &= ~TIMEDOUT;
+      state = TIMEDOUT;
+
+    } else if(pending(s, INTERRUPTED)) {
+
+      n &= ~INTERRUPTED;
+      state = INTERRUPTED;
+
+    } else if(s == n)
+      return INVALID;
+
+    if(Futex::cas(&_state, s, n) == s)
+      return state;
+
+  }
+
+}
+
+Monitor::STATE Monitor::wait(unsigned long ms) {
+
+  if(ms == 0)
+    return block(0);
+
+  Deadline deadline(ms / 1000, (ms % 1000) * 1000000);
+  return block(&deadline);
+
+}
+
+Monitor::STATE Monitor::wait(const Deadline& deadline) {
+
+  return block(&deadline);
+
+}
+
+Monitor::STATE Monitor::block(const Deadline* deadline) {
+
+  // Update the owner on first use. The owner will not change, each
+  // thread waits only on a single Monitor and a Monitor is never
+  // shared
+  if(_owner == 0)
+    _owner = pthread_self();
+
+  // Return without waiting when possible
+  STATE state = next();
+  if(state != INVALID)
+    return state;
+     
+  // Unlock the external lock if a wait() is probably needed. 
+  _lock.release();
+  
+  // Wait for a transition in the state that is of interest, this
+  // allows waits to exclude certain flags (e.g. INTERRUPTED) 
+  // for a single wait() w/o actually discarding those flags -
+  // they will remain set until a wait interested in those flags
+  // occurs.
+  for(;;) {
+
+    // Publish the WAITING flag, anyone changing the state from here on 
+    // will wake this thread
+    int s = Futex::set(&_state, WAITING) | WAITING;
+    if(pending(s, ANYTHING))
+      break;
+    
+    if(deadline == 0) {
+
+      Futex::wait(&_state, s);
+      continue;
+
+    }
+
+    // The futex timeout is relative, measure what is left of the deadline
+    unsigned long secs, nanos;
+    struct ::timespec timeout;
+
+    bool left = deadline->remaining(secs, nanos);
+
+    timeout.tv_sec  = secs;
+    timeout.tv_nsec = nanos;
+
+    // When a timeout occurs, update the state to reflect that.
+    if(!left || Futex::wait(&_state, s, &timeout) == ETIMEDOUT) {
+
+      Futex::set(&_state, TIMEDOUT);
+      break;
+
+    }
+
+  }
+  
+  // Get the next available STATE, this also clears the WAITING flag
+  state = next();
+  assert(state != INVALID);
+    
+  // Reaquire the external lock, keep from deadlocking threads calling 
+  // notify(), interrupt(), etc.
+  _lock.acquire();
+
+  return state;
+
+}
+
+
+bool Monitor::interrupt() {
+
+  int s = _state;
+
+  // Update the state & wake the waiter if there is one
+  while(!pending(s, INTERRUPTED)) {
+
+    int prev = Futex::cas(&_state, s, s | INTERRUPTED);
+    if(prev != s) {
+      s = prev;
+      continue;
+    }
+
+    if((s & WAITING) && !masked(INTERRUPTED)) {
+
+      Futex::wake(&_state);
+      return false;
+
+    }
+
+    // Only returns true when an interrupted thread is not currently blocked
+    return !pthread_equal(_owner, pthread_self());
+
+  }
+
+  return false;
+
+}
+
+bool Monitor::isInterrupted() {
+
+  int s = Futex::unset(&_state, INTERRUPTED);
+  return pending(s, INTERRUPTED);
+
+}
+
+bool Monitor::isCanceled() {
+
+  bool wasCanceled = (_state & CANCELED) != 0;
+    
+  if(pthread_equal(_owner, pthread_self()))
+    Futex::unset(&_state, INTERRUPTED);
+
+  return wasCanceled;
+
+}
+
+bool Monitor::cancel() {
+
+  int s = _state;
+
+  for(;;) {
+
+    bool wasInterrupted = !pending(s, INTERRUPTED);
+    int n = s | CANCELED | (wasInterrupted ? INTERRUPTED : 0);
+
+    int prev = Futex::cas(&_state, s, n);
+    if(prev != s) {
+      s = prev;
+      continue;
+    }
+    
+    // Wake the waiter if there is one
+    if(wasInterrupted && (s & WAITING) && !masked(INTERRUPTED))
+      Futex::wake(&_state);
+    
+    return wasInterrupted;
+
+  }
+
+}
+
+bool Monitor::notify() {
+
+  int s = _state;
+
+  // Set the flag and wake the waiter if there is one
+  while(!pending(s, INTERRUPTED)) {
+
+    int prev = Futex::cas(&_state, s, s | SIGNALED);
+    if(prev != s) {
+      s = prev;
+      continue;
+    }
+
+    if(s & WAITING)
+      Futex::wake(&_state);
+
+    return true;
+
+  }
+
+  return false;
+
+}
+
+} // namespace ZThread
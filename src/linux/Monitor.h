@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTMONITOR_H__
+#define __ZTMONITOR_H__
+
+#include "../Status.h"
+#include "../FastLock.h"
+#include "zthread/Deadline.h"
+#include "Futex.h"
+#include <pthread.h>
+
+namespace ZThread {
+
+/**
+ * @class Monitor
+ * @version 2.3.3
+ *
+ * This implementation of a Monitor keeps its pending STATE's in a single
+ * word, and blocks the owning thread on that word with a futex. A notify(),
+ * interrupt() or cancel() is a single atomic update of the word, and only
+ * enters the kernel when the owner is actually blocked.
+ *
+ * The interest mask is still kept by the Status, it is only ever changed 
+ * by the owning thread.
+ */
+class Monitor : private Status, private NonCopyable {
+ private:
+
+  //! Set in the status word while the owner is blocked
+  enum { WAITING = 0x100 };
+
+  //! Serialize access to external objects
+  FastLock _lock;
+
+  //! Pending STATE's and the WAITING flag
+  volatile int _state;
+
+  //! Owning thread
+  pthread_t _owner;
+
+ public:
+
+  typedef Status::STATE STATE;
+
+  using Status::INVALID;
+  using Status::SIGNALED;
+  using Status::INTERRUPTED;
+  using Status::TIMEDOUT;
+  using Status::CANCELED;
+  using Status::ANYTHING;
+
+  using Status::interest;
+
+  //! Create a new monitor.
+  Monitor();
+
+  //! Destroy the monitor.
+  ~Monitor();
+
+  //! Acquire the lock for this monitor. 
+  inline void acquire() {
+    _lock.acquire();
+  }
+
+  //! Acquire the lock for this monitor. 
+  inline bool tryAcquire() {
+    return _lock.tryAcquire();
+  }
+
+  //! Release the lock for this monitor
+  inline void release() {
+    _lock.release();
+  }
+
+  /**
+   * Wait for a state change and atomically unlock the external lock.
+   * Blocks for an indefinent amount of time. 
+   *
+   * @return INTERRUPTED if the wait was ended by a interrupt()
+   *         or SIGNALED if the wait was ended by a notify()
+   *
+   * @post the external lock is always acquired before this function returns
+   */
+  inline STATE wait() {
+    return wait(0);
+  }
+
+  /**
+   * Wait for a state change and atomically unlock the external lock.
+   * May blocks for an indefinent amount of time. 
+   *
+   * @param timeout - maximum time to block (milliseconds) or 0 to
+   * block indefinently
+   * 
+   * @return INTERRUPTED if the wait was ended by a interrupt()
+   *         or TIMEDOUT if the maximum wait time expired.
+   *         or SIGNALED if the wait was ended by a notify()
+   *
+   * @post the external lock is always acquired before this function returns
+   */
+  STATE wait(unsigned long timeout);
+
+  /**
+   * Wait for a state change and atomically unlock the external lock.
+   * Blocks no later than the given Deadline. 
+   *
+   * @param deadline - time at which to stop waiting
+   * 
+   * @return INTERRUPTED if the wait was ended by a interrupt()
+   *         or TIMEDOUT if the deadline passed.
+   *         or SIGNALED if the wait was ended by a notify()
+   *
+   * @post the external lock is always acquired before this function returns
+   */
+  STATE wait(const Deadline& deadline);
+
+  /**
+   * Interrupt this monitor. If there is a thread blocked on this monitor object
+   * it will be signaled and released. If there is no waiter, a flag is set and
+   * the next attempt to wait() will return INTERRUPTED w/o blocking.
+   *
+   * @return false if the thread was previously INTERRUPTED.
+   */
+  bool interrupt();
+
+  /**
+   * Notify this monitor. If there is a thread blocked on this monitor object
+   * it will be signaled and released. If there is no waiter, a flag is set and 
+   * the next attempt to wait() will return SIGNALED w/o blocking, if no other 
+   * flag is set. 
+   *
+   * @return false if the thread was previously INTERRUPTED.
+   */
+  bool notify();
+
+  /**
+   * Check the state of this monitor, clearing the INTERRUPTED status if set.
+   *
+   * @return bool true if the monitor was INTERRUPTED.
+   * @post INTERRUPTED flag cleared if the calling thread owns the monitor.
+   */
+  bool isInterrupted();
+
+  /**
+   * Mark the Status CANCELED, and INTERRUPT the montor.
+   *
+   * @see interrupt()
+   */
+  bool cancel();
+
+  /**
+   * Test the CANCELED Status, clearing the INTERRUPTED status if set.
+   *
+   * @return bool
+   */
+  bool isCanceled();
+
+ private:
+
+  //! Test a status word against the interest mask 
+  inline bool pending(int state, int mask) {
+    return (state & ~WAITING & _mask & mask) != INVALID;
+  }
+
+  /**
+   * Atomically take the next STATE from the status word, in the same order
+   * Status::next() reports them, and clear the WAITING flag.
+   *
+   * @return STATE, or INVALID if nothing of interest is pending
+   * @pre called ONLY by the owning thread.
+   */
+  STATE next();
+
+  /**
+   * Block until a STATE of interest is pending or the deadline passes.
+   *
+   * @param deadline - time at which to stop waiting, or 0 to wait indefinently
+   */
+  STATE block(const Deadline* deadline);
+
+};
+
+};
+
+#endif
@@ -25,6 +25,7 @@
 
 #include "../Status.h"
 #include "../FastLock.h"
+#include "zthread/Deadline.h"
 
 namespace ZThread {
 
@@ -108,6 +109,27 @@ class Monitor : public Status, private NonCopyable {
    */
   STATE wait(unsigned long timeout);
 
+  /**
+   * Wait for a state change and atomically unlock the external lock.
+   * Blocks no later than the given Deadline, rounded up to the next 
+   * millisecond; this implementation only waits with millisecond 
+   * resolution. 
+   *
+   * @param deadline - time at which to stop waiting
+   * 
+   * @return INTERRUPTED if the wait was ended by a interrupt()
+   *         or TIMEDOUT if the deadline passed.
+   *         or SIGNALED if the wait was ended by a notify()
+   *
+   * @post the external lock is always acquired before this function returns
+   */
+  inline STATE wait(const Deadline& deadline) {
+
+    unsigned long ms = deadline.milliseconds();
+    return wait(ms == 0 ? 1 : ms);
+
+  }
+
   /**
    * Interrupt this monitor. If there is a thread blocked on this monitor object
    * it will be signaled and released. If there is no waiter, a flag is set and
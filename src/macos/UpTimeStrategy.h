@@ -62,6 +62,10 @@ class TimeStrategy {
     return _ms;
   }
 
+  inline unsigned long nanoseconds() const {  
+    return _ms*1000000;
+  }
+
   unsigned long seconds(unsigned long s) {
 
     unsigned long z = seconds();
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2005, Eric Crahen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef __ZTTIMESTRATEGY_H__
+#define __ZTTIMESTRATEGY_H__
+
+#include <time.h>
+
+namespace ZThread {
+
+/**
+ * @class TimeStrategy
+ *
+ * Implement a strategy for time operatons based on clock_gettime, 
+ * using the monotonic clock so that changes to the system time (e.g. 
+ * NTP steps) do not affect the timing of waits.
+ */
+class TimeStrategy {
+
+  struct timespec _value;
+
+public:
+
+  TimeStrategy() {
+    clock_gettime(CLOCK_MONOTONIC, &_value);
+  }
+
+  inline unsigned long seconds() const {
+    return _value.tv_sec;
+  }
+
+  inline unsigned long milliseconds() const {
+    return _value.tv_nsec/1000000;
+  }
+
+  inline unsigned long nanoseconds() const {
+    return _value.tv_nsec;
+  }
+
+  unsigned long seconds(unsigned long s) {
+
+    unsigned long z = seconds();
+    _value.tv_sec = s;
+
+    return z;
+
+  }
+
+  unsigned long milliseconds(unsigned long ms) {
+
+    unsigned long z = milliseconds();
+    _value.tv_nsec = ms*1000000;
+
+    return z;
+
+  }
+
+};
+
+};
+
+#endif // __ZTTIMESTRATEGY_H__
@@ -56,9 +56,26 @@ class FastLock : private NonCopyable {
    */
   inline FastLock() {
 
+#if defined(PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP) && !defined(ZTHREAD_DISABLE_ADAPTIVE_SPIN)
+
+    // Spin briefly before sleeping when the library provides adaptive mutexes
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+
+    int result = pthread_mutex_init(&_mtx, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    if(result != 0)
+      throw Initialization_Exception();
+
+#else
+
     if(pthread_mutex_init(&_mtx, 0) != 0)
       throw Initialization_Exception();
 
+#endif
+
   }
   
   /**
@@ -59,6 +59,10 @@ public:
     return _value.millitm;    
   }
 
+  inline unsigned long nanoseconds() const {  
+    return _value.millitm*1000000UL;    
+  }
+
   unsigned long seconds(unsigned long s) {
 
     unsigned long z = seconds();
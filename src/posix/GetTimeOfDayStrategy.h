@@ -50,6 +50,10 @@ public:
     return _value.tv_usec/1000;
   }
 
+  inline unsigned long nanoseconds() const {
+    return _value.tv_usec*1000;
+  }
+
   unsigned long seconds(unsigned long s) {
 
     unsigned long z = seconds();
@@ -32,7 +32,22 @@ namespace ZThread {
 
 Monitor::Monitor() : _owner(0), _waiting(false) {
   
+#if defined(HAVE_CLOCK_MONOTONIC)
+
+  // Time waits against the same clock as the TimeStrategy
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+  pthread_cond_init(&_waitCond, &attr);
+  pthread_condattr_destroy(&attr);
+
+#else
+
   pthread_cond_init(&_waitCond, 0);
+
+#endif
+
   pthread_mutex_init(&_waitLock, 0);
 
 }
@@ -48,6 +63,22 @@ Monitor::~Monitor() {
 
 Monitor::STATE Monitor::wait(unsigned long ms) {
 
+  if(ms == 0)
+    return block(0);
+
+  Deadline deadline(ms / 1000, (ms % 1000) * 1000000);
+  return block(&deadline);
+
+}
+
+Monitor::STATE Monitor::wait(const Deadline& deadline) {
+
+  return block(&deadline);
+
+}
+
+Monitor::STATE Monitor::block(const Deadline* deadline) {
+
   // Update the owner on first use. The owner will not change, each
   // thread waits only on a single Monitor and a Monitor is never
   // shared
@@ -86,7 +117,7 @@ Monitor::STATE Monitor::wait(unsigned long ms) {
   _waiting = true;
   int status = 0;
   
-  if(ms == 0) { // Wait forever 
+  if(deadline == 0) { // Wait forever 
     
     do { // ignore signals unless the state is interesting  
       status = pthread_cond_wait(&_waitCond, &_waitLock);
@@ -97,19 +128,12 @@ Monitor::STATE Monitor::wait(unsigned long ms) {
     
   } else {
     
-    // Find the target time
-    TimeStrategy t; 
-
-    ms += t.milliseconds();
-
-    unsigned long s = t.seconds() + (ms / 1000);
-    ms %= 1000;
-
-    // Convert to a timespec
+    // The deadline is measured against the clock the condition 
+    // variable uses, convert it to a timespec
     struct ::timespec timeout;   
     
-    timeout.tv_sec = s; 
-    timeout.tv_nsec = ms*1000000;
+    timeout.tv_sec = deadline->seconds(); 
+    timeout.tv_nsec = deadline->nanoseconds();
     
     // Wait ignoring signals until the state is interesting    
     do { 
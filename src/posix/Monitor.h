@@ -25,6 +25,8 @@
 
 #include "../Status.h"
 #include "../FastLock.h"
+#include "zthread/Deadline.h"
+#include <pthread.h>
 
 namespace ZThread {
 
@@ -105,6 +107,20 @@ class Monitor : public Status, private NonCopyable {
    */
   STATE wait(unsigned long timeout);
 
+  /**
+   * Wait for a state change and atomically unlock the external lock.
+   * Blocks no later than the given Deadline. 
+   *
+   * @param deadline - time at which to stop waiting
+   * 
+   * @return INTERRUPTED if the wait was ended by a interrupt()
+   *         or TIMEDOUT if the deadline passed.
+   *         or SIGNALED if the wait was ended by a notify()
+   *
+   * @post the external lock is always acquired before this function returns
+   */
+  STATE wait(const Deadline& deadline);
+
   /**
    * Interrupt this monitor. If there is a thread blocked on this monitor object
    * it will be signaled and released. If there is no waiter, a flag is set and
@@ -146,6 +162,15 @@ class Monitor : public Status, private NonCopyable {
    */
   bool isCanceled();
 
+ private:
+
+  /**
+   * Block until a STATE of interest is pending or the deadline passes.
+   *
+   * @param deadline - time at which to stop waiting, or 0 to wait indefinently
+   */
+  STATE block(const Deadline* deadline);
+
 };
 
 };
@@ -70,6 +70,10 @@ public:
     return _millis;    
   }
 
+  unsigned long nanoseconds() const {  
+    return _millis*1000000;    
+  }
+
   unsigned long seconds(unsigned long s) {
 
     unsigned long z = seconds();